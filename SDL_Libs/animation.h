@@ -18,6 +18,7 @@
 #include <iostream>
 #include <string>
 #include <cinttypes>
+#include <algorithm>
 
 #include "texture.h"
 #include <vector>
@@ -26,9 +27,27 @@
 const int STANDARD_ANIMATION_SPEED  = 100; //in milliseconds
 static std::vector<SDL_Rect*> STANDARD_CLIPRECTS = {nullptr};
 static std::vector<unsigned int> STANDARD_CHANGE_TIMES = {STANDARD_ANIMATION_SPEED};
+const unsigned int MAX_CLIP_FRAMES = 4096;//longer frame tables are cut off
+
+//one entry of the frame table of an Animation or AnimationClip
+struct ClipFrame{
+	unsigned int texture;//index into the textures
+	SDL_Rect clip;
+	bool clipped;//false shows the whole texture
+	unsigned int duration;//in milliseconds, at least 1
+};
+
+//paths, cliprects and change times wrap around on their own, the table holds every combination until they repeat
+//texture_of gives the texture index of every path
+static void build_frame_table(const std::vector<unsigned int>& texture_of, const std::vector<SDL_Rect*>& cliprects, const std::vector<unsigned int>& change_times, std::vector<ClipFrame>& frames);
 
 /*
 *
+*	All frames are loaded when the animation is loaded and their texture, cliprect and change time
+*	are put into one frame table. Changing frames only moves an index into it,
+*	there is no loading or allocating while the animation runs.
+*	For a sprite sheet pass one path and a cliprect per frame.
+*
 *Example usage:
 *	Animation sprite;
 *	//initializing renderer usw.
@@ -51,22 +70,20 @@ class Animation{
 
 private:
 
-	Texture texture;
+	std::vector<Texture> textures; //one loaded texture per path
 
-	Window* window;
+	Window* window = nullptr;
 	SDL_Rect* renderrect = nullptr;
 
 	uint8_t alpha = 0xff;
 	SDL_BlendMode blendmode = STANDARD_BLENDMODE;
 
 	std::vector<std::string> paths; //all the different paths, a path gets changed whe the corresponding change time is reached
-	std::vector<SDL_Rect*> cliprects; //different cliprects
-	std::vector<unsigned int> change_times; //the change times, after the change time is reached change_time_ptr is updated
+	std::vector<unsigned int> change_times; //the change times, kept to build the table again when the cliprects change
+	size_t cliprect_count = 1;
+	std::vector<ClipFrame> frames; //frame i shows path i % paths, cliprect i % cliprects for change time i % change times
 
-	unsigned int last_path_ptr = 0; //for checking if image has changed
-	unsigned int path_ptr = 0;
-	unsigned int cliprect_ptr = 0;
-	unsigned int change_time_ptr = 0;
+	unsigned int frame_ptr = 0;
 
 	uint8_t r=0xff, g=0xff, b=0xff; //for color modulation
 
@@ -79,7 +96,15 @@ private:
 	SDL_Point* center = nullptr;
 
 
-	void load_texture();
+	//loads every path once
+	void load_textures();
+	//applies the drawing state to a texture
+	void apply_state(Texture&) const;
+	//points the current texture to the current cliprect
+	void show_frame();
+	void build_frames(const std::vector<SDL_Rect*>&);
+	//the first frame showing path pp, cliprect cp and change time ctp, or the closest one the lists reach
+	void find_frame(unsigned int pp, unsigned int cp, unsigned int ctp);
 
 public:
 
@@ -126,6 +151,8 @@ public:
 	void set_path_ptr(const unsigned int);
 	void set_cliprect_ptr(const unsigned int);
 	void set_change_time_ptr(const unsigned int);
+	unsigned int get_path_ptr() const;
+	unsigned int get_cliprect_ptr() const;
 
 	//needs to be called for the sprite to be update
 	void make_update();
@@ -133,10 +160,15 @@ public:
 	void reset_animation();
 	void reset_timer();
 
-	Animation& operator=(Animation&&);
-	Animation& operator=(Animation&);
+	//moving hands over the frames and rects without loading anything
+	Animation& operator=(Animation&&) noexcept;
+	Animation& operator=(const Animation&);
 	Animation(const Animation&);
-	Animation(const Animation&&);
+	Animation(Animation&&) noexcept;
+
+private:
+
+	void move_from(Animation&);
 
 };
 
@@ -147,15 +179,13 @@ Animation::Animation(){
 
 Animation::Animation(Window* window_ptr, std::vector<std::string> paths, std::vector<SDL_Rect*> cliprects, std::vector<unsigned int> change_times, SDL_Rect* renderrect, bool running){
 	this->paths = paths;
-	this->cliprects = cliprects;
 	this->change_times = change_times;
 	this->renderrect = renderrect;
 	this->running = running;
 	this->window = window_ptr;
 
-	last_path_ptr = path_ptr+1;
-
-	load_texture();
+	build_frames(cliprects);
+	load_textures();
 }
 
 Animation::~Animation(){
@@ -167,24 +197,102 @@ Animation::~Animation(){
 
 void Animation::load(Window* window_ptr, std::vector<std::string> paths, std::vector<SDL_Rect*> cliprects, std::vector<unsigned int> change_times){
 	this->paths = paths;
-	this->cliprects = cliprects;
 	this->change_times = change_times;
 	this->window = window_ptr;
 
-	last_path_ptr = path_ptr+1;
+	build_frames(cliprects);
+	load_textures();
+}
 
-	load_texture();
+static unsigned int clip_gcd(unsigned int a, unsigned int b){
+	while (b != 0){
+		unsigned int t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
 }
 
-void Animation::load_texture(){
-	if (last_path_ptr != path_ptr){
-		texture.load(paths[path_ptr], window);
-		last_path_ptr = path_ptr;
+static void build_frame_table(const std::vector<unsigned int>& texture_of, const std::vector<SDL_Rect*>& cliprects, const std::vector<unsigned int>& change_times, std::vector<ClipFrame>& frames){
+
+	frames.clear();
+	if (texture_of.empty()) return;
+
+	const std::vector<SDL_Rect*>& rects = cliprects.empty() ? STANDARD_CLIPRECTS : cliprects;
+	const std::vector<unsigned int>& times = change_times.empty() ? STANDARD_CHANGE_TIMES : change_times;
+
+	//after lcm of the three sizes everything repeats
+	unsigned long long count = texture_of.size();
+	count = count / clip_gcd(static_cast<unsigned int>(count), static_cast<unsigned int>(rects.size())) * rects.size();
+	if (count > MAX_CLIP_FRAMES) count = MAX_CLIP_FRAMES;
+	count = count / clip_gcd(static_cast<unsigned int>(count), static_cast<unsigned int>(times.size())) * times.size();
+	if (count > MAX_CLIP_FRAMES) count = MAX_CLIP_FRAMES;
+
+	frames.resize(static_cast<size_t>(count));
+	for (size_t i = 0; i < frames.size(); i++){
+
+		ClipFrame& f = frames[i];
+		f.texture = texture_of[i % texture_of.size()];
+
+		SDL_Rect* rect = rects[i % rects.size()];
+		f.clipped = (rect != nullptr);
+		f.clip = (rect != nullptr) ? *rect : SDL_Rect{0, 0, 0, 0};
+
+		f.duration = std::max(times[i % times.size()], 1u);
+
 	}
-	if (cliprects[cliprect_ptr] != nullptr) texture.set_cliprect(*(cliprects[cliprect_ptr]));
-	if(renderrect != nullptr){
-		texture.set_renderrect(*(renderrect));
+
+}
+
+void Animation::build_frames(const std::vector<SDL_Rect*>& rects){
+
+	if (change_times.empty()) change_times = STANDARD_CHANGE_TIMES;
+	cliprect_count = rects.empty() ? 1 : rects.size();
+
+	//every path has its own texture
+	std::vector<unsigned int> texture_of(paths.size());
+	for (size_t i = 0; i < paths.size(); i++) texture_of[i] = static_cast<unsigned int>(i);
+
+	build_frame_table(texture_of, rects, change_times, frames);
+	if (frame_ptr >= frames.size()) frame_ptr = 0;
+
+}
+
+void Animation::find_frame(unsigned int pp, unsigned int cp, unsigned int ctp){
+
+	if (frames.empty()) return;
+
+	//lists with sizes sharing a divisor do not reach every combination, then the change time and the cliprect are given up first
+	int best = -1, best_score = -1;
+	for (size_t i = 0; i < frames.size() && best_score < 3; i++){
+		if (i % paths.size() != pp) continue;
+		int score = 1 + ((i % cliprect_count == cp) ? 1 : 0) + ((i % cliprect_count == cp && i % change_times.size() == ctp) ? 1 : 0);
+		if (score > best_score){
+			best = static_cast<int>(i);
+			best_score = score;
+		}
 	}
+	if (best >= 0) frame_ptr = static_cast<unsigned int>(best);
+
+}
+
+void Animation::load_textures(){
+
+	textures.clear();
+	textures.resize(paths.size());
+	for (size_t i = 0; i < paths.size(); i++){
+		textures[i].load(paths[i], window);
+		apply_state(textures[i]);
+	}
+
+	if (frame_ptr >= frames.size()) frame_ptr = 0;
+	show_frame();
+}
+
+void Animation::apply_state(Texture& texture) const{
+
+	if(renderrect != nullptr) texture.set_renderrect(*(renderrect));
+	else texture.unset_renderrect();
 
 	texture.modulate_color(r, g, b);
 	texture.set_blendmode(blendmode);
@@ -195,47 +303,55 @@ void Animation::load_texture(){
 	}
 }
 
+void Animation::show_frame(){
+
+	if (textures.empty() || frames.empty()) return;
+
+	//the texture only switches a flag, nothing is allocated or freed
+	const ClipFrame& f = frames[frame_ptr];
+	if (f.clipped) textures[f.texture].set_cliprect(f.clip);
+	else textures[f.texture].unset_cliprect();
+
+}
+
 int Animation::get_width() const{
 
-	return texture.get_width();
+	if (textures.empty()) return 0;
+	return textures[get_path_ptr()].get_width();
 
 }
 
 int Animation::get_height() const{
-	return texture.get_height();
+	if (textures.empty()) return 0;
+	return textures[get_path_ptr()].get_height();
 }
 
 void Animation::set_cliprects(std::vector<SDL_Rect*> rects){
-	cliprects = rects;
-	if (cliprect_ptr >= cliprects.size()) cliprect_ptr = 0;
-	if (cliprects[cliprect_ptr] != nullptr){
-		texture.set_cliprect(*(cliprects[cliprect_ptr]));
-	}
-	else texture.unset_cliprect();
+	build_frames(rects);
+	show_frame();
 }
 
 void Animation::set_renderrect(const SDL_Rect& r){
 	if(renderrect != nullptr) delete renderrect;
 	renderrect = new SDL_Rect{r};
-	texture.set_renderrect(*(renderrect));
+	for (Texture& texture : textures) texture.set_renderrect(*(renderrect));
 }
 
 void Animation::unset_cliprects(){
-	cliprects=STANDARD_CLIPRECTS;
-	cliprect_ptr = 0;
-	texture.unset_cliprect();
+	build_frames(STANDARD_CLIPRECTS);
+	show_frame();
 }
 
 void Animation::unset_renderrect(){
 	if (renderrect != nullptr) delete renderrect;
 	renderrect = nullptr;
-	texture.unset_renderrect();
+	for (Texture& texture : textures) texture.unset_renderrect();
 }
 
 
 void Animation::set_window(Window* window_ptr){
 	window = window_ptr;
-	texture.load(paths[path_ptr], window);
+	for (Texture& texture : textures) texture.set_window(window);
 }
 
 Window const* Animation::get_window() const{
@@ -246,13 +362,13 @@ void Animation::modulate_color(uint8_t r, uint8_t g, uint8_t b){
 	this->r = r;
 	this->g = g;
 	this->b = b;
-	texture.modulate_color(r, g, b);
+	for (Texture& texture : textures) texture.modulate_color(r, g, b);
 }
 
 void Animation::set_blendmode(const SDL_BlendMode b){
 
 	blendmode = b;
-	texture.set_blendmode(b);
+	for (Texture& texture : textures) texture.set_blendmode(b);
 
 }
 
@@ -265,7 +381,7 @@ const SDL_BlendMode Animation::get_blendmode() const{
 void Animation::set_alpha(const uint8_t a){
 
 	alpha = a;
-	texture.set_alpha(a);
+	for (Texture& texture : textures) texture.set_alpha(a);
 
 }
 
@@ -278,23 +394,18 @@ void Animation::make_update(){
 
 
 		std::chrono::milliseconds update = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
-		std::chrono::milliseconds to_elapse = std::chrono::milliseconds(change_times[change_time_ptr]);
+		if (frames.empty()) return;
+		std::chrono::milliseconds to_elapse = std::chrono::milliseconds(frames[frame_ptr].duration);
 
 		if ((update - last_update) > to_elapse){
 			//update is needed
 			last_update = update;
 
-			path_ptr += 1;
-			if(path_ptr >= paths.size()) path_ptr = 0;
-
-			cliprect_ptr += 1;
-			if (cliprect_ptr >= cliprects.size()) cliprect_ptr = 0;
+			frame_ptr += 1;
+			if (frame_ptr >= frames.size()) frame_ptr = 0;
 
-			change_time_ptr += 1;
-			if(change_time_ptr >= change_times.size()) change_time_ptr = 0;
-
-			//loading new image
-			load_texture();
+			//every frame is loaded already
+			show_frame();
 
 		}
 	}
@@ -303,15 +414,15 @@ void Animation::make_update(){
 
 void Animation::draw() {
 
-	//change happened, able to draw now
-	texture.draw();
+	if (textures.empty() || frames.empty()) return;
+	textures[frames[frame_ptr].texture].draw();
 
 }
 
 void Animation::draw(int x, int y, int w, int h){
 
-	//change happend, able to draw now
-	texture.draw(x, y, w, h);
+	if (textures.empty() || frames.empty()) return;
+	textures[frames[frame_ptr].texture].draw(x, y, w, h);
 }
 
 
@@ -325,27 +436,33 @@ void Animation::start_animation(){
 }
 
 void Animation::set_path_ptr(const unsigned int pp){
-	if(pp < paths.size()) path_ptr = pp;
-	load_texture();
+	if(pp < paths.size()) find_frame(pp, get_cliprect_ptr(), frame_ptr % change_times.size());
+	show_frame();
 }
 
 void Animation::set_cliprect_ptr(const unsigned int cp){
-	if (cp < cliprects.size()) cliprect_ptr = cp;
-	load_texture();
+	if (cp < cliprect_count && !paths.empty()) find_frame(get_path_ptr(), cp, frame_ptr % change_times.size());
+	show_frame();
 }	
 
 void Animation::set_change_time_ptr(const unsigned int ctp){
-	if(ctp < change_times.size()) change_time_ptr = ctp;
-	load_texture();
+	if(ctp < change_times.size() && !paths.empty()) find_frame(get_path_ptr(), get_cliprect_ptr(), ctp);
+	show_frame();
+}
+
+unsigned int Animation::get_path_ptr() const{
+	return paths.empty() ? 0 : frame_ptr % paths.size();
+}
+
+unsigned int Animation::get_cliprect_ptr() const{
+	return frame_ptr % cliprect_count;
 }
 
 void Animation::reset_animation(){
 
-	path_ptr = 0;
-	cliprect_ptr = 0;
-	change_time_ptr = 0;
+	frame_ptr = 0;
 
-	load_texture();
+	show_frame();
 
 	last_update = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
 
@@ -357,7 +474,7 @@ void Animation::reset_timer(){
 
 void Animation::set_angle(const double a){
 	angle = a;
-	texture.set_angle(a);
+	for (Texture& texture : textures) texture.set_angle(a);
 }
 
 void Animation::rotation_config(const SDL_Point& p, const SDL_RendererFlip f){
@@ -367,26 +484,70 @@ void Animation::rotation_config(const SDL_Point& p, const SDL_RendererFlip f){
 
 	flipType = f;
 
-	texture.rotation_config(p, f);
+	for (Texture& texture : textures) texture.rotation_config(p, f);
 }
 
-Animation& Animation::operator=(Animation&& a){
+void Animation::move_from(Animation& other){
+
+	textures = std::move(other.textures);
+	window = other.window;
+	renderrect = other.renderrect;
+	center = other.center;
+
+	alpha = other.alpha;
+	blendmode = other.blendmode;
+	paths = std::move(other.paths);
+	change_times = std::move(other.change_times);
+	cliprect_count = other.cliprect_count;
+	frames = std::move(other.frames);
+
+	frame_ptr = other.frame_ptr;
+	r = other.r;
+	g = other.g;
+	b = other.b;
+	running = other.running;
+	last_update = other.last_update;
+	flipType = other.flipType;
+	angle = other.angle;
 
-	load(a.window, a.paths, a.cliprects, a.change_times);
+	other.renderrect = nullptr;
+	other.center = nullptr;
+
+}
+
+Animation& Animation::operator=(Animation&& a) noexcept{
+
+	if (this != &a){
+		if (renderrect != nullptr) delete renderrect;
+		if (center != nullptr) delete center;
+		move_from(a);
+	}
 	return (*this);
 }
 
-Animation& Animation::operator=(Animation& a){
+Animation& Animation::operator=(const Animation& a){
 
-	load(a.window, a.paths, a.cliprects, a.change_times);
+	if (this != &a){
+		paths = a.paths;
+		change_times = a.change_times;
+		cliprect_count = a.cliprect_count;
+		frames = a.frames;
+		window = a.window;
+		load_textures();
+	}
 	return (*this);
 }
 
 Animation::Animation(const Animation& other){
-	load(other.window, other.paths, other.cliprects, other.change_times);
-}
-Animation::Animation(const Animation&& other){
-	load(other.window, other.paths, other.cliprects, other.change_times);
+	paths = other.paths;
+	change_times = other.change_times;
+	cliprect_count = other.cliprect_count;
+	frames = other.frames;
+	window = other.window;
+	load_textures();
+}
+Animation::Animation(Animation&& other) noexcept{
+	move_from(other);
 }
 
 
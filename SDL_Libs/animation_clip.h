@@ -0,0 +1,289 @@
+#ifndef __ANIMATION_CLIP__
+#define __ANIMATION_CLIP__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <cinttypes>
+#include <algorithm>
+#include <unordered_map>
+
+#include "window.h"
+#include "texture.h"
+#include "animation.h"
+#include "spritebatch.h"
+
+//flags of an AnimationPlayer
+const uint8_t PLAYER_RUNNING = 0x1;
+const uint8_t PLAYER_LOOP = 0x2;
+const uint8_t PLAYER_FINISHED = 0x4;//set when a clip without PLAYER_LOOP reached its end
+
+/*
+*
+*	The frames of an animation, loaded once and shared by every sprite that plays them.
+*	An AnimationPlayer only knows its clip, the current frame and the time in that frame,
+*	so thousands of animated sprites can be kept in one std::vector.
+*
+*	Example usage:
+*		AnimationClip walk(&window, {"walk.png"}, {&frame0, &frame1, &frame2, &frame3}, {80});
+*		std::vector<AnimationPlayer> players(5000, AnimationPlayer(&walk));
+*		//in the game loop, dt in milliseconds
+*		for (AnimationPlayer& p : players) p.update(dt);
+*		batch.begin();
+*		for (size_t i = 0; i < players.size(); i++) players[i].add(batch, x[i], y[i]);
+*		batch.end();
+*
+*	The clip has to outlive its players.
+*
+*/
+
+class AnimationClip{
+
+protected:
+
+	Window* window = nullptr;
+	std::vector<Texture> textures;//one per distinct path
+	std::vector<ClipFrame> frames;
+	unsigned int total_duration = 0;
+
+public:
+
+	AnimationClip();
+	//paths, cliprects and change times repeat independently like in Animation, the frame table holds every combination
+	AnimationClip(Window* w, const std::vector<std::string>& paths, const std::vector<SDL_Rect*>& cliprects=STANDARD_CLIPRECTS, const std::vector<unsigned int>& change_times=STANDARD_CHANGE_TIMES);
+
+	virtual ~AnimationClip();
+
+	void load(Window* w, const std::vector<std::string>& paths, const std::vector<SDL_Rect*>& cliprects=STANDARD_CLIPRECTS, const std::vector<unsigned int>& change_times=STANDARD_CHANGE_TIMES);
+
+	unsigned int frame_count() const;
+	const ClipFrame& get_frame(unsigned int) const;
+	//one pass through all frames in milliseconds
+	unsigned int get_duration() const;
+	int get_width(unsigned int frame) const;
+	int get_height(unsigned int frame) const;
+
+	//moves a playhead dt milliseconds on, true if another frame is shown than before
+	bool advance(uint32_t& frame, uint32_t& elapsed, uint8_t& flags, uint32_t dt) const;
+
+	//w and h of -1 take the size of the frame
+	void draw(unsigned int frame, int x, int y, int w=-1, int h=-1, SDL_RendererFlip flip=STANDARD_FLIPTYPE, const SDL_Color& c=BATCH_WHITE, SDL_BlendMode bm=STANDARD_BLENDMODE) const;
+	void add(SpriteBatch& b, unsigned int frame, int x, int y, int w=-1, int h=-1, SDL_RendererFlip flip=STANDARD_FLIPTYPE, const SDL_Color& c=BATCH_WHITE, SDL_BlendMode bm=STANDARD_BLENDMODE) const;
+
+	//players point into the clip
+	AnimationClip(const AnimationClip&) = delete;
+	AnimationClip& operator=(const AnimationClip&) = delete;
+
+};
+
+struct AnimationPlayer{
+
+	const AnimationClip* clip = nullptr;
+	uint32_t frame = 0;
+	uint32_t elapsed = 0;//milliseconds spent in the current frame
+	uint8_t flags = PLAYER_RUNNING | PLAYER_LOOP;
+
+	AnimationPlayer();
+	AnimationPlayer(const AnimationClip*, uint8_t flags=PLAYER_RUNNING | PLAYER_LOOP);
+
+	//advances by dt milliseconds, true if another frame is shown than before
+	bool update(uint32_t dt);
+
+	void play();
+	void stop();
+	//back to the first frame, running again
+	void reset();
+	bool is_running() const;
+	bool is_finished() const;
+
+	void draw(int x, int y, int w=-1, int h=-1, SDL_RendererFlip flip=STANDARD_FLIPTYPE) const;
+	void add(SpriteBatch& b, int x, int y, int w=-1, int h=-1, SDL_RendererFlip flip=STANDARD_FLIPTYPE) const;
+
+};
+
+//IMPLEMENTATION
+AnimationClip::AnimationClip(){
+}
+
+AnimationClip::AnimationClip(Window* window_ptr, const std::vector<std::string>& paths, const std::vector<SDL_Rect*>& cliprects, const std::vector<unsigned int>& change_times){
+	load(window_ptr, paths, cliprects, change_times);
+}
+
+AnimationClip::~AnimationClip(){
+}
+
+void AnimationClip::load(Window* window_ptr, const std::vector<std::string>& paths, const std::vector<SDL_Rect*>& cliprects, const std::vector<unsigned int>& change_times){
+
+	window = window_ptr;
+	textures.clear();
+	frames.clear();
+	total_duration = 0;
+	if (paths.empty()) return;
+
+	//the same path in the list is loaded once
+	std::unordered_map<std::string, unsigned int> loaded;
+	std::vector<unsigned int> texture_of(paths.size());
+	textures.reserve(paths.size());
+	for (size_t i = 0; i < paths.size(); i++){
+		auto it = loaded.find(paths[i]);
+		if (it != loaded.end()){
+			texture_of[i] = it->second;
+			continue;
+		}
+		texture_of[i] = static_cast<unsigned int>(textures.size());
+		loaded[paths[i]] = texture_of[i];
+		textures.emplace_back();
+		textures.back().load(paths[i], window);
+	}
+
+	build_frame_table(texture_of, cliprects, change_times, frames);
+	for (const ClipFrame& f : frames) total_duration += f.duration;
+
+}
+
+unsigned int AnimationClip::frame_count() const{
+	return static_cast<unsigned int>(frames.size());
+}
+
+const ClipFrame& AnimationClip::get_frame(unsigned int i) const{
+	return frames[i];
+}
+
+unsigned int AnimationClip::get_duration() const{
+	return total_duration;
+}
+
+int AnimationClip::get_width(unsigned int frame) const{
+	if (frame >= frames.size()) return 0;
+	const ClipFrame& f = frames[frame];
+	return f.clipped ? f.clip.w : textures[f.texture].get_width();
+}
+
+int AnimationClip::get_height(unsigned int frame) const{
+	if (frame >= frames.size()) return 0;
+	const ClipFrame& f = frames[frame];
+	return f.clipped ? f.clip.h : textures[f.texture].get_height();
+}
+
+void AnimationClip::draw(unsigned int frame, int x, int y, int w, int h, SDL_RendererFlip flip, const SDL_Color& c, SDL_BlendMode bm) const{
+
+	if (window == nullptr || frame >= frames.size()) return;
+
+	const ClipFrame& f = frames[frame];
+	SDL_Texture* t = textures[f.texture].drawn_texture();
+	if (t == nullptr) return;
+
+	if (w == -1) w = get_width(frame);
+	if (h == -1) h = get_height(frame);
+	SDL_Rect dst = {x, y, w, h};
+
+	//the texture may be shared with other textures, so the modulation is set on every draw
+	SDL_SetTextureColorMod(t, c.r, c.g, c.b);
+	SDL_SetTextureAlphaMod(t, c.a);
+	SDL_SetTextureBlendMode(t, bm);
+	SDL_RenderCopyEx(window->renderer, t, f.clipped ? &f.clip : nullptr, &dst, 0.0, nullptr, flip);
+
+}
+
+void AnimationClip::add(SpriteBatch& b, unsigned int frame, int x, int y, int w, int h, SDL_RendererFlip flip, const SDL_Color& c, SDL_BlendMode bm) const{
+
+	if (frame >= frames.size()) return;
+
+	const ClipFrame& f = frames[frame];
+	SDL_Texture* t = textures[f.texture].drawn_texture();
+	if (t == nullptr) return;
+
+	if (w == -1) w = get_width(frame);
+	if (h == -1) h = get_height(frame);
+	SDL_FRect dst = {static_cast<float>(x), static_cast<float>(y), static_cast<float>(w), static_cast<float>(h)};
+
+	b.add(t, f.clipped ? &f.clip : nullptr, dst, 0.0, nullptr, flip, c, bm);
+
+}
+
+bool AnimationClip::advance(uint32_t& frame, uint32_t& elapsed, uint8_t& flags, uint32_t dt) const{
+
+	if (!(flags & PLAYER_RUNNING) || frames.empty()) return false;
+	if (frame >= frames.size()) frame = 0;//the clip was loaded again with less frames
+
+	uint32_t before = frame;
+
+	elapsed += dt;
+	//whole passes through a looping clip change nothing
+	if ((flags & PLAYER_LOOP) && elapsed >= total_duration + frames[frame].duration) elapsed %= total_duration;
+
+	while (elapsed >= frames[frame].duration){
+
+		if (frame + 1 >= frames.size() && !(flags & PLAYER_LOOP)){
+			elapsed = 0;
+			flags = (flags & ~PLAYER_RUNNING) | PLAYER_FINISHED;
+			break;
+		}
+
+		elapsed -= frames[frame].duration;
+		frame = (frame + 1 < frames.size()) ? frame + 1 : 0;
+
+	}
+
+	return frame != before;
+
+}
+
+AnimationPlayer::AnimationPlayer(){
+}
+
+AnimationPlayer::AnimationPlayer(const AnimationClip* c, uint8_t flags){
+	this->clip = c;
+	this->flags = flags;
+}
+
+bool AnimationPlayer::update(uint32_t dt){
+
+	if (clip == nullptr) return false;
+	return clip->advance(frame, elapsed, flags, dt);
+
+}
+
+void AnimationPlayer::play(){
+	flags |= PLAYER_RUNNING;
+}
+
+void AnimationPlayer::stop(){
+	flags &= ~PLAYER_RUNNING;
+}
+
+void AnimationPlayer::reset(){
+	frame = 0;
+	elapsed = 0;
+	flags = (flags | PLAYER_RUNNING) & ~PLAYER_FINISHED;
+}
+
+bool AnimationPlayer::is_running() const{
+	return (flags & PLAYER_RUNNING) != 0;
+}
+
+bool AnimationPlayer::is_finished() const{
+	return (flags & PLAYER_FINISHED) != 0;
+}
+
+void AnimationPlayer::draw(int x, int y, int w, int h, SDL_RendererFlip flip) const{
+	if (clip != nullptr) clip->draw(frame, x, y, w, h, flip);
+}
+
+void AnimationPlayer::add(SpriteBatch& b, int x, int y, int w, int h, SDL_RendererFlip flip) const{
+	if (clip != nullptr) clip->add(b, frame, x, y, w, h, flip);
+}
+
+#endif
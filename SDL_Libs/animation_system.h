@@ -0,0 +1,257 @@
+#ifndef __ANIMATION_SYSTEM__
+#define __ANIMATION_SYSTEM__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <cinttypes>
+
+#include "spritebatch.h"
+#include "animation_clip.h"
+
+const size_t ANIMATION_SPLIT = 16384;//playheads a thread gets at least before update splits the work
+
+/*
+*
+*	Advances many animation playheads at once from one frame delta.
+*	The playheads are stored as structure of arrays, so the update walks tightly packed frame and time arrays
+*	and only looks at the clip of playheads whose current frame ran out.
+*	update gives back how many playheads show another frame, get_changed tells which ones.
+*
+*	Example usage:
+*		AnimationSystem animations;
+*		uint32_t id = animations.add(&walk);
+*		//in the game loop, dt in milliseconds
+*		animations.update(dt);
+*		for (uint32_t i : animations.get_changed()) //only these need a new cliprect
+*		batch.begin();
+*		animations.add(batch, id, x, y);
+*		batch.end();
+*
+*/
+
+class AnimationSystem{
+
+protected:
+
+	//index i of every array is one playhead
+	std::vector<const AnimationClip*> clips;
+	std::vector<uint32_t> frames;
+	std::vector<uint32_t> elapsed;
+	std::vector<uint8_t> flags;
+
+	std::vector<uint32_t> free_ids;//removed playheads, reused by add
+	std::vector<uint32_t> changed;
+	std::vector<std::vector<uint32_t>> thread_changed;//one list per extra thread, merged after the update
+
+	unsigned int threads = 1;
+
+	void update_range(size_t begin, size_t end, uint32_t dt, std::vector<uint32_t>& out);
+
+public:
+
+	//more than one thread splits big updates, 0 picks one per core
+	AnimationSystem(unsigned int threads=1);
+	virtual ~AnimationSystem();
+
+	//the id stays valid until it is removed
+	uint32_t add(const AnimationClip*, uint8_t flags=PLAYER_RUNNING | PLAYER_LOOP);
+	void remove(uint32_t id);
+	void clear();
+	//slots in use, including removed ones waiting for reuse
+	size_t size() const;
+
+	//advances every running playhead, gives back how many show another frame
+	size_t update(uint32_t dt);
+	//the playheads that changed frame in the last update, in ascending order
+	const std::vector<uint32_t>& get_changed() const;
+
+	void set_threads(unsigned int);
+	unsigned int get_threads() const;
+
+	const AnimationClip* get_clip(uint32_t id) const;
+	uint32_t get_frame(uint32_t id) const;
+	void play(uint32_t id);
+	void stop(uint32_t id);
+	void reset(uint32_t id);
+	bool is_running(uint32_t id) const;
+	bool is_finished(uint32_t id) const;
+
+	void draw(uint32_t id, int x, int y, int w=-1, int h=-1, SDL_RendererFlip flip=STANDARD_FLIPTYPE) const;
+	void add(SpriteBatch& b, uint32_t id, int x, int y, int w=-1, int h=-1, SDL_RendererFlip flip=STANDARD_FLIPTYPE) const;
+
+};
+
+//IMPLEMENTATION
+AnimationSystem::AnimationSystem(unsigned int threads){
+	set_threads(threads);
+}
+
+AnimationSystem::~AnimationSystem(){
+}
+
+uint32_t AnimationSystem::add(const AnimationClip* clip, uint8_t f){
+
+	if (!free_ids.empty()){
+		uint32_t id = free_ids.back();
+		free_ids.pop_back();
+		clips[id] = clip;
+		frames[id] = 0;
+		elapsed[id] = 0;
+		flags[id] = f;
+		return id;
+	}
+
+	clips.push_back(clip);
+	frames.push_back(0);
+	elapsed.push_back(0);
+	flags.push_back(f);
+	return static_cast<uint32_t>(clips.size() - 1);
+
+}
+
+void AnimationSystem::remove(uint32_t id){
+
+	if (id >= clips.size() || clips[id] == nullptr) return;
+
+	clips[id] = nullptr;
+	flags[id] = 0;
+	free_ids.push_back(id);
+
+}
+
+void AnimationSystem::clear(){
+	clips.clear();
+	frames.clear();
+	elapsed.clear();
+	flags.clear();
+	free_ids.clear();
+	changed.clear();
+}
+
+size_t AnimationSystem::size() const{
+	return clips.size();
+}
+
+void AnimationSystem::update_range(size_t begin, size_t end, uint32_t dt, std::vector<uint32_t>& out){
+
+	for (size_t i = begin; i < end; i++){
+
+		const AnimationClip* clip = clips[i];
+		if (!(flags[i] & PLAYER_RUNNING) || clip == nullptr) continue;
+
+		//most playheads stay in their frame, that needs only one look into the clip
+		if (frames[i] < clip->frame_count() && elapsed[i] + dt < clip->get_frame(frames[i]).duration){
+			elapsed[i] += dt;
+			continue;
+		}
+
+		if (clip->advance(frames[i], elapsed[i], flags[i], dt)) out.push_back(static_cast<uint32_t>(i));
+
+	}
+
+}
+
+size_t AnimationSystem::update(uint32_t dt){
+
+	changed.clear();
+
+	size_t count = clips.size();
+	size_t parts = std::min(static_cast<size_t>(threads), count / ANIMATION_SPLIT);
+	if (parts <= 1){
+		update_range(0, count, dt, changed);
+		return changed.size();
+	}
+
+	//the main thread takes the first part, the lists are merged in order afterwards
+	thread_changed.resize(parts - 1);
+	std::vector<std::thread> workers;
+	size_t part = (count + parts - 1) / parts;
+
+	for (size_t p = 1; p < parts; p++){
+		std::vector<uint32_t>& out = thread_changed[p - 1];
+		out.clear();
+		size_t begin = p * part, end = std::min(begin + part, count);
+		workers.push_back(std::thread(&AnimationSystem::update_range, this, begin, end, dt, std::ref(out)));
+	}
+	update_range(0, std::min(part, count), dt, changed);
+
+	for (std::thread& t : workers) t.join();
+	for (const std::vector<uint32_t>& out : thread_changed) changed.insert(changed.end(), out.begin(), out.end());
+
+	return changed.size();
+
+}
+
+const std::vector<uint32_t>& AnimationSystem::get_changed() const{
+	return changed;
+}
+
+void AnimationSystem::set_threads(unsigned int t){
+
+	if (t == 0) t = std::thread::hardware_concurrency();
+	threads = (t > 0) ? t : 1;
+
+}
+
+unsigned int AnimationSystem::get_threads() const{
+	return threads;
+}
+
+const AnimationClip* AnimationSystem::get_clip(uint32_t id) const{
+	return (id < clips.size()) ? clips[id] : nullptr;
+}
+
+uint32_t AnimationSystem::get_frame(uint32_t id) const{
+	return (id < frames.size()) ? frames[id] : 0;
+}
+
+void AnimationSystem::play(uint32_t id){
+	if (id < clips.size() && clips[id] != nullptr) flags[id] |= PLAYER_RUNNING;
+}
+
+void AnimationSystem::stop(uint32_t id){
+	if (id < flags.size()) flags[id] &= ~PLAYER_RUNNING;
+}
+
+void AnimationSystem::reset(uint32_t id){
+
+	if (id >= clips.size() || clips[id] == nullptr) return;
+
+	frames[id] = 0;
+	elapsed[id] = 0;
+	flags[id] = (flags[id] | PLAYER_RUNNING) & ~PLAYER_FINISHED;
+
+}
+
+bool AnimationSystem::is_running(uint32_t id) const{
+	return id < flags.size() && (flags[id] & PLAYER_RUNNING) != 0;
+}
+
+bool AnimationSystem::is_finished(uint32_t id) const{
+	return id < flags.size() && (flags[id] & PLAYER_FINISHED) != 0;
+}
+
+void AnimationSystem::draw(uint32_t id, int x, int y, int w, int h, SDL_RendererFlip flip) const{
+	if (id < clips.size() && clips[id] != nullptr) clips[id]->draw(frames[id], x, y, w, h, flip);
+}
+
+void AnimationSystem::add(SpriteBatch& b, uint32_t id, int x, int y, int w, int h, SDL_RendererFlip flip) const{
+	if (id < clips.size() && clips[id] != nullptr) clips[id]->add(b, frames[id], x, y, w, h, flip);
+}
+
+#endif
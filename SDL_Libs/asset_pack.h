@@ -0,0 +1,389 @@
+#ifndef __ASSET_PACK__
+#define __ASSET_PACK__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#include <windows.h>
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cinttypes>
+#include <unordered_map>
+#include "window.h"
+#include "texture_cache.h"
+
+const char ASSET_PACK_MAGIC[8] = {'S', 'D', 'L', 'P', 'A', 'C', 'K', '1'};
+const uint32_t STANDARD_PACK_FORMAT = SDL_PIXELFORMAT_ARGB8888;
+const uint64_t ASSET_PACK_ALIGNMENT = 16;
+
+/*
+*
+*	A single file with images that are already decoded and converted to a pixel format.
+*	Loading one is a memory mapping plus an upload, no PNG decoding at startup.
+*
+*	Packing (offline, see asset_packer.cpp):
+*		AssetPack::write("level1.pack", {"enemy.png", "tree.png"}, SDL_PIXELFORMAT_ARGB8888);
+*
+*	Example usage:
+*		AssetPack pack("level1.pack");
+*		TextureCache::instance().mount(&pack);
+*		Texture enemy("enemy.png", &window);//comes out of the pack
+*
+*	The pack has to outlive all textures loaded from it.
+*	The file is written in the byte order of the machine packing it.
+*
+*/
+
+struct AssetPackHeader{
+	char magic[8];
+	uint32_t count;
+	uint32_t format;
+	uint64_t names_offset;
+};
+
+struct AssetPackEntry{
+	uint64_t data_offset;
+	uint32_t name_offset;//relative to names_offset
+	uint32_t name_length;
+	int32_t width, height, pitch;
+	uint32_t reserved;
+};
+
+class AssetPack: public ImageSource{
+
+protected:
+
+	const uint8_t* data = nullptr;//the mapped file
+	size_t size = 0;
+	uint32_t format = SDL_PIXELFORMAT_UNKNOWN;
+
+	std::unordered_map<std::string, const AssetPackEntry*> index;
+
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int file = -1;
+#endif
+
+	bool map_file(const std::string& path);
+	void unmap_file();
+	//false if the name or the pixels of the entry reach past the file, or its size makes no sense
+	bool check_entry(const AssetPackEntry&, uint64_t names_offset) const;
+
+public:
+
+	AssetPack();
+	AssetPack(const std::string& path);
+	virtual ~AssetPack();
+
+	bool open(const std::string& path);
+	void close();
+	bool is_open() const;
+
+	size_t get_count() const;
+	uint32_t get_format() const;
+	std::vector<std::string> get_names() const;
+
+	bool contains(const std::string& name) const;
+	SDL_Texture* create_texture(const std::string& name, SDL_Renderer* r, int& w, int& h, uint32_t& fmt);
+	SDL_Surface* load_surface(const std::string& name, uint32_t fmt);
+	bool get_size(const std::string& name, int& w, int& h) const;
+
+	//decodes the images and writes them as a pack, names are the paths as given
+	static bool write(const std::string& out, const std::vector<std::string>& paths, uint32_t format=STANDARD_PACK_FORMAT);
+
+	AssetPack(const AssetPack&) = delete;
+	AssetPack& operator=(const AssetPack&) = delete;
+
+};
+
+AssetPack::AssetPack(){
+}
+
+AssetPack::AssetPack(const std::string& path){
+	open(path);
+}
+
+AssetPack::~AssetPack(){
+	close();
+}
+
+bool AssetPack::map_file(const std::string& path){
+
+#ifdef _WIN32
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER file_size;
+	GetFileSizeEx(file, &file_size);
+	size = static_cast<size_t>(file_size.QuadPart);
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) return false;
+	data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+	file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0) return false;
+
+	struct stat st;
+	if (fstat(file, &st) != 0) return false;
+	size = static_cast<size_t>(st.st_size);
+
+	void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	if (mapped == MAP_FAILED) return false;
+	data = static_cast<const uint8_t*>(mapped);
+#endif
+
+	return data != nullptr;
+
+}
+
+void AssetPack::unmap_file(){
+
+#ifdef _WIN32
+	if (data != nullptr) UnmapViewOfFile(data);
+	if (mapping != nullptr) CloseHandle(mapping);
+	if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+	mapping = nullptr;
+	file = INVALID_HANDLE_VALUE;
+#else
+	if (data != nullptr) munmap(const_cast<uint8_t*>(data), size);
+	if (file >= 0) ::close(file);
+	file = -1;
+#endif
+
+	data = nullptr;
+	size = 0;
+
+}
+
+bool AssetPack::open(const std::string& path){
+
+	close();
+
+	if (!map_file(path) || size < sizeof(AssetPackHeader)){
+		std::cout << "Asset pack with path: " << path << " could not be opened" << std::endl;
+		unmap_file();
+		return false;
+	}
+
+	const AssetPackHeader* header = reinterpret_cast<const AssetPackHeader*>(data);
+	uint64_t index_end = sizeof(AssetPackHeader) + static_cast<uint64_t>(header->count) * sizeof(AssetPackEntry);
+
+	if (memcmp(header->magic, ASSET_PACK_MAGIC, sizeof(ASSET_PACK_MAGIC)) != 0 || index_end > size || header->names_offset > size){
+		std::cout << "Asset pack with path: " << path << " is no valid pack" << std::endl;
+		unmap_file();
+		return false;
+	}
+
+	format = header->format;
+
+	const AssetPackEntry* entries = reinterpret_cast<const AssetPackEntry*>(data + sizeof(AssetPackHeader));
+	const char* names = reinterpret_cast<const char*>(data + header->names_offset);
+
+	for (uint32_t i = 0; i < header->count; i++){
+
+		const AssetPackEntry& e = entries[i];
+
+		//a truncated or broken pack is not used at all
+		if (!check_entry(e, header->names_offset)){
+			std::cout << "Asset pack with path: " << path << " is broken at entry " << i << std::endl;
+			index.clear();
+			unmap_file();
+			return false;
+		}
+
+		index[std::string(names + e.name_offset, e.name_length)] = &e;
+
+	}
+
+	return true;
+
+}
+
+bool AssetPack::check_entry(const AssetPackEntry& e, uint64_t names_offset) const{
+
+	//names_offset was checked against the file size, adding two 32 bit values to it can not overflow
+	if (names_offset + e.name_offset + e.name_length > size) return false;
+
+	uint64_t bpp = SDL_BYTESPERPIXEL(format);
+	if (bpp == 0 || e.width <= 0 || e.height <= 0 || e.pitch <= 0) return false;
+	if (static_cast<uint64_t>(e.pitch) < static_cast<uint64_t>(e.width) * bpp) return false;
+
+	if (e.data_offset > size) return false;
+	return static_cast<uint64_t>(e.pitch) * static_cast<uint64_t>(e.height) <= size - e.data_offset;
+
+}
+
+void AssetPack::close(){
+
+	//no texture of the pack may be loaded again after this
+	TextureCache::instance().unmount(this);
+	index.clear();
+	unmap_file();
+
+}
+
+bool AssetPack::is_open() const{
+	return data != nullptr;
+}
+
+size_t AssetPack::get_count() const{
+	return index.size();
+}
+
+uint32_t AssetPack::get_format() const{
+	return format;
+}
+
+std::vector<std::string> AssetPack::get_names() const{
+	std::vector<std::string> names;
+	for (auto& e : index) names.push_back(e.first);
+	return names;
+}
+
+bool AssetPack::contains(const std::string& name) const{
+	return index.find(name) != index.end();
+}
+
+SDL_Texture* AssetPack::create_texture(const std::string& name, SDL_Renderer* r, int& w, int& h, uint32_t& fmt){
+
+	auto it = index.find(name);
+	if (it == index.end()) return nullptr;
+
+	const AssetPackEntry* e = it->second;
+	w = e->width;
+	h = e->height;
+	fmt = format;
+
+	//uploading right out of the mapped file
+	SDL_Texture* t = SDL_CreateTexture(r, format, SDL_TEXTUREACCESS_STATIC, w, h);
+	SDL_UpdateTexture(t, nullptr, data + e->data_offset, e->pitch);
+	if (SDL_ISPIXELFORMAT_ALPHA(format)) SDL_SetTextureBlendMode(t, SDL_BLENDMODE_BLEND);
+
+	return t;
+
+}
+
+SDL_Surface* AssetPack::load_surface(const std::string& name, uint32_t fmt){
+
+	auto it = index.find(name);
+	if (it == index.end()) return nullptr;
+
+	const AssetPackEntry* e = it->second;
+	void* pixels = const_cast<uint8_t*>(data + e->data_offset);
+
+	SDL_Surface* view = SDL_CreateRGBSurfaceWithFormatFrom(pixels, e->width, e->height, SDL_BITSPERPIXEL(format), e->pitch, format);
+	if (view == nullptr) return nullptr;
+
+	//the mapping is read only, so the caller gets a copy
+	SDL_Surface* copy = SDL_ConvertSurfaceFormat(view, fmt != SDL_PIXELFORMAT_UNKNOWN ? fmt : format, 0);
+	SDL_FreeSurface(view);
+	return copy;
+
+}
+
+bool AssetPack::get_size(const std::string& name, int& w, int& h) const{
+
+	auto it = index.find(name);
+	if (it == index.end()) return false;
+
+	w = it->second->width;
+	h = it->second->height;
+	return true;
+
+}
+
+bool AssetPack::write(const std::string& out, const std::vector<std::string>& paths, uint32_t format){
+
+	std::vector<SDL_Surface*> surfaces;
+	for (const std::string& path : paths){
+
+		SDL_Surface* s = IMG_Load(path.c_str());
+		if (s == nullptr){
+			std::cout << "Image with path: " << path << " could not be loaded" << std::endl;
+			for (SDL_Surface* done : surfaces) SDL_FreeSurface(done);
+			return false;
+		}
+		surfaces.push_back(SDL_ConvertSurfaceFormat(s, format, 0));
+		SDL_FreeSurface(s);
+
+	}
+
+	AssetPackHeader header;
+	memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(ASSET_PACK_MAGIC));
+	header.count = static_cast<uint32_t>(paths.size());
+	header.format = format;
+	header.names_offset = sizeof(AssetPackHeader) + paths.size() * sizeof(AssetPackEntry);
+
+	std::vector<AssetPackEntry> entries(paths.size());
+	std::string names;
+	for (unsigned int i = 0; i < paths.size(); i++){
+		entries[i].name_offset = static_cast<uint32_t>(names.size());
+		entries[i].name_length = static_cast<uint32_t>(paths[i].size());
+		names += paths[i];
+	}
+
+	uint64_t offset = header.names_offset + names.size();
+	for (unsigned int i = 0; i < paths.size(); i++){
+		offset = (offset + ASSET_PACK_ALIGNMENT - 1) & ~(ASSET_PACK_ALIGNMENT - 1);
+		entries[i].data_offset = offset;
+		entries[i].width = surfaces[i]->w;
+		entries[i].height = surfaces[i]->h;
+		entries[i].pitch = surfaces[i]->w * SDL_BYTESPERPIXEL(format);
+		entries[i].reserved = 0;
+		offset += static_cast<uint64_t>(entries[i].pitch) * entries[i].height;
+	}
+
+	std::ofstream file(out.c_str(), std::ios::binary);
+	if (!file){
+		std::cout << "Asset pack with path: " << out << " could not be written" << std::endl;
+		for (SDL_Surface* s : surfaces) SDL_FreeSurface(s);
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(AssetPackEntry));
+	file.write(names.data(), names.size());
+
+	uint64_t written = header.names_offset + names.size();
+	const char zeros[ASSET_PACK_ALIGNMENT] = {0};
+
+	for (unsigned int i = 0; i < paths.size(); i++){
+
+		file.write(zeros, entries[i].data_offset - written);
+
+		//rows without the padding SDL may add to the pitch
+		const char* pixels = static_cast<const char*>(surfaces[i]->pixels);
+		for (int y = 0; y < surfaces[i]->h; y++){
+			file.write(pixels + y * surfaces[i]->pitch, entries[i].pitch);
+		}
+
+		written = entries[i].data_offset + static_cast<uint64_t>(entries[i].pitch) * entries[i].height;
+		SDL_FreeSurface(surfaces[i]);
+
+	}
+
+	return static_cast<bool>(file);
+
+}
+
+#endif
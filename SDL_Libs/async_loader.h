@@ -0,0 +1,306 @@
+#ifndef __ASYNC_LOADER__
+#define __ASYNC_LOADER__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <deque>
+#include <utility>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include "window.h"
+#include "texture_cache.h"
+
+const unsigned int STANDARD_UPLOAD_BUDGET = 4;//textures uploaded per frame
+const int STANDARD_PLACEHOLDER_SIZE = 32;
+
+/*
+*
+*	Decodes images on worker threads, only the upload to the renderer happens on the main thread.
+*
+*	Example usage:
+*		AsyncLoader loader;
+*		Texture t;
+*		t.load_async("PATH.png", &window, loader);
+*		while (running){
+*			loader.upload();//once per frame, uploads at most the upload budget
+*			t.draw();//draws a placeholder until the image arrived
+*		}
+*
+*	The loader has to outlive all textures that are still waiting for their image.
+*
+*/
+
+enum AsyncState{
+					ASYNC_PENDING,
+					ASYNC_DECODED,
+					ASYNC_READY,
+					ASYNC_FAILED
+				};
+
+struct AsyncImage{
+
+	std::string path;
+	SDL_Renderer* renderer = nullptr;
+	uint32_t format = SDL_PIXELFORMAT_UNKNOWN;
+
+	std::atomic<int> state;
+
+	SDL_Surface* surface = nullptr;//decoded by a worker, freed after the upload
+	int width = STANDARD_PLACEHOLDER_SIZE, height = STANDARD_PLACEHOLDER_SIZE;
+
+	CachedTexture* entry = nullptr;//the real texture, set once state is ASYNC_READY
+	CachedTexture* placeholder = nullptr;//drawn while the image is not ready
+
+	AsyncImage();
+	~AsyncImage();
+
+};
+
+typedef std::shared_ptr<AsyncImage> AsyncHandle;
+
+class AsyncLoader{
+
+protected:
+
+	std::vector<std::thread> workers;
+	std::mutex lock;
+	std::condition_variable wake;
+
+	std::deque<AsyncHandle> queued;//waiting for a worker
+	std::deque<AsyncHandle> decoded;//waiting for the upload
+	std::unordered_map<TextureKey, AsyncHandle, TextureKeyHash> in_flight;//only touched on the main thread
+
+	bool finished = false;
+	unsigned int upload_budget = STANDARD_UPLOAD_BUDGET;
+
+	void run_worker();
+	CachedTexture* get_placeholder(SDL_Renderer*);
+
+public:
+
+	AsyncLoader(unsigned int threads=0, unsigned int budget=STANDARD_UPLOAD_BUDGET);//0 threads picks one per spare core
+	virtual ~AsyncLoader();
+
+	//starts decoding the image, w and h are the placeholder size until the real size is known
+	AsyncHandle request(const std::string& path, Window* window_ptr, int w=STANDARD_PLACEHOLDER_SIZE, int h=STANDARD_PLACEHOLDER_SIZE);
+	//needs to be called once per frame on the main thread, gives back how many textures were uploaded
+	unsigned int upload();
+	//uploads everything, blocking until all requests are done
+	void finish();
+
+	void set_upload_budget(unsigned int);
+	unsigned int get_upload_budget() const;
+	size_t pending();
+
+	AsyncLoader(const AsyncLoader&) = delete;
+	AsyncLoader& operator=(const AsyncLoader&) = delete;
+
+};
+
+AsyncImage::AsyncImage(): state(ASYNC_PENDING){
+}
+
+AsyncImage::~AsyncImage(){
+
+	if (surface != nullptr) SDL_FreeSurface(surface);
+	TextureCache::instance().release(entry);
+	TextureCache::instance().release(placeholder);
+
+}
+
+AsyncLoader::AsyncLoader(unsigned int threads, unsigned int budget){
+
+	if (threads == 0){
+		threads = std::thread::hardware_concurrency();
+		threads = threads > 1 ? threads - 1 : 1;
+	}
+
+	upload_budget = budget;
+	for (unsigned int i = 0; i < threads; i++){
+		workers.push_back(std::thread(&AsyncLoader::run_worker, this));
+	}
+
+}
+
+AsyncLoader::~AsyncLoader(){
+
+	lock.lock();
+	finished = true;
+	lock.unlock();
+	wake.notify_all();
+
+	for (std::thread& t : workers) t.join();
+
+	//the handles get freed here on the main thread, together with their cache references
+	queued.clear();
+	decoded.clear();
+	in_flight.clear();
+
+}
+
+void AsyncLoader::run_worker(){
+
+	while (true){
+
+		AsyncHandle job;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			wake.wait(guard, [this]{ return finished || !queued.empty(); });
+			if (finished) return;
+			job = queued.front();
+			queued.pop_front();
+		}
+
+		SDL_Surface* s = IMG_Load(job->path.c_str());
+		if (s != nullptr){
+			job->surface = SDL_ConvertSurfaceFormat(s, job->format, 0);
+			if (job->surface == nullptr) job->surface = s;
+			else SDL_FreeSurface(s);
+		}
+
+		//the reference is handed over under the lock, else the last one could be dropped here, off the main thread
+		lock.lock();
+		job->state = (job->surface != nullptr) ? ASYNC_DECODED : ASYNC_FAILED;
+		decoded.push_back(std::move(job));
+		lock.unlock();
+
+	}
+
+}
+
+CachedTexture* AsyncLoader::get_placeholder(SDL_Renderer* r){
+
+	const std::string key = "async:placeholder";
+
+	CachedTexture* entry = TextureCache::instance().find(key, r);
+	if (entry != nullptr) return entry;
+
+	//a 2x2 magenta/black checker, scaled up to whatever size gets drawn
+	SDL_Texture* t = SDL_CreateTexture(r, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 2, 2);
+	uint32_t pixels[4] = {0xffff00ff, 0xff000000, 0xff000000, 0xffff00ff};
+	SDL_UpdateTexture(t, nullptr, pixels, 2 * sizeof(uint32_t));
+
+	return TextureCache::instance().insert(key, r, t, nullptr, 2, 2);
+
+}
+
+AsyncHandle AsyncLoader::request(const std::string& path, Window* window_ptr, int w, int h){
+
+	if (window_ptr == nullptr) return nullptr;
+
+	auto it = in_flight.find(TextureKey{path, window_ptr->renderer});
+	if (it != in_flight.end()) return it->second;
+
+	AsyncHandle job = std::make_shared<AsyncImage>();
+	job->path = path;
+	job->renderer = window_ptr->renderer;
+	job->width = w;
+	job->height = h;
+
+	job->entry = TextureCache::instance().find(path, window_ptr->renderer);
+	if (job->entry != nullptr){
+		//already loaded, nothing to decode
+		job->width = job->entry->width;
+		job->height = job->entry->height;
+		job->state = ASYNC_READY;
+		return job;
+	}
+
+	job->format = SDL_GetWindowPixelFormat(window_ptr->window);
+	job->placeholder = get_placeholder(window_ptr->renderer);
+	in_flight[TextureKey{path, window_ptr->renderer}] = job;
+
+	lock.lock();
+	queued.push_back(job);
+	lock.unlock();
+	wake.notify_one();
+
+	return job;
+
+}
+
+unsigned int AsyncLoader::upload(){
+
+	unsigned int uploaded = 0;
+
+	while (uploaded < upload_budget){
+
+		AsyncHandle job;
+		lock.lock();
+		if (!decoded.empty()){
+			job = decoded.front();
+			decoded.pop_front();
+		}
+		lock.unlock();
+
+		if (job == nullptr) break;
+		in_flight.erase(TextureKey{job->path, job->renderer});
+
+		if (job->state == ASYNC_FAILED){
+			std::cout << "Image with path: " << job->path << " could not be loaded" << std::endl;
+			continue;
+		}
+
+		job->entry = TextureCache::instance().find(job->path, job->renderer);
+		if (job->entry == nullptr){
+			SDL_Texture* t = SDL_CreateTextureFromSurface(job->renderer, job->surface);
+			job->entry = TextureCache::instance().insert(job->path, job->renderer, t, job->surface, job->surface->w, job->surface->h, CPU_AND_GPU, true);
+			uploaded += 1;
+		}
+		else SDL_FreeSurface(job->surface);
+
+		job->surface = nullptr;//owned by the cache now
+		job->width = job->entry->width;
+		job->height = job->entry->height;
+		job->state = ASYNC_READY;
+
+	}
+
+	return uploaded;
+
+}
+
+void AsyncLoader::finish(){
+
+	unsigned int budget = upload_budget;
+	upload_budget = -1;
+
+	while (!in_flight.empty()){
+		if (upload() == 0) std::this_thread::yield();
+	}
+
+	upload_budget = budget;
+
+}
+
+void AsyncLoader::set_upload_budget(unsigned int budget){
+	upload_budget = budget;
+}
+
+unsigned int AsyncLoader::get_upload_budget() const{
+	return upload_budget;
+}
+
+size_t AsyncLoader::pending(){
+	return in_flight.size();
+}
+
+#endif
@@ -0,0 +1,389 @@
+#ifndef __ATLAS__
+#define __ATLAS__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <cinttypes>
+#include "window.h"
+#include "texture.h"
+
+const int STANDARD_ATLAS_SIZE = 2048;
+const int STANDARD_ATLAS_PADDING = 1;//empty pixels between two images, against bleeding when scaling
+const uint32_t ATLAS_PIXELFORMAT = SDL_PIXELFORMAT_ARGB8888;
+
+/*
+*
+*	Packs many small images into a few big textures, so drawing them does not need a texture switch each time.
+*
+*	Example usage:
+*		TextureAtlas atlas(&window);
+*		atlas.add("PATH1.png");
+*		atlas.add("PATH2.png");
+*		atlas.build();
+*		AtlasSprite sprite = atlas.get("PATH1.png");
+*		sprite.draw(x, y);
+*
+*	The atlas has to outlive all of its sprites.
+*	Images added after a build go into the free space of the existing pages, so sprites from earlier builds stay valid.
+*
+*/
+
+//a small handle to a part of an atlas page, drawn like a Texture
+class SpriteBatch;
+
+class AtlasSprite{
+
+	friend class SpriteBatch;
+
+protected:
+
+	SDL_Texture* page = nullptr;
+	Window* window = nullptr;
+	SDL_Rect cliprect = {0, 0, 0, 0};//where the image lies on the page
+
+	SDL_Rect renderrect = {0, 0, 0, 0};
+	SDL_Point center = {0, 0};
+	bool has_renderrect = false, has_center = false;
+
+	SDL_BlendMode blendmode = STANDARD_BLENDMODE;
+	SDL_RendererFlip flipType = STANDARD_FLIPTYPE;
+	uint8_t alpha = 0xff;
+	uint8_t r=0xff, g=0xff, b=0xff;
+	double angle = 0.0;
+
+	void apply_modulation() const;
+
+public:
+
+	AtlasSprite();
+	AtlasSprite(SDL_Texture* page, Window* window_ptr, const SDL_Rect& clip);
+
+	int get_width() const;
+	int get_height() const;
+	SDL_Texture* get_page() const;
+	const SDL_Rect& get_cliprect() const;
+
+	void set_renderrect(const SDL_Rect&);
+	void unset_renderrect();
+	void modulate_color(const uint8_t, const uint8_t, const uint8_t);
+	void set_blendmode(const SDL_BlendMode);
+	const SDL_BlendMode get_blendmode() const;
+	void set_alpha(const uint8_t);
+	const uint8_t get_alpha() const;
+	void set_angle(const double);
+	const double get_angle() const;
+	void rotation_config(const SDL_Point&, const SDL_RendererFlip f=STANDARD_FLIPTYPE);
+
+	void draw() const;
+	void draw(int x, int y, int w=-1, int h=-1) const;
+
+};
+
+struct AtlasRegion{
+	unsigned int page;
+	SDL_Rect rect;
+};
+
+//one texture of the atlas, filled with rows as high as their first image
+struct AtlasPage{
+	SDL_Texture* texture;
+	int w, h;
+	int shelf_y, shelf_h, cursor_x;//where the next image goes
+};
+
+class TextureAtlas{
+
+protected:
+
+	Window* window = nullptr;
+	int page_size = STANDARD_ATLAS_SIZE;
+	int padding = STANDARD_ATLAS_PADDING;
+
+	std::vector<std::string> queued;//added, but not packed yet
+	std::vector<AtlasPage> pages;//pages for oversized images can differ from page_size
+	std::unordered_map<std::string, AtlasRegion> regions;
+
+	long long used_area = 0;
+
+	void free_pages();
+	//finds room for a w x h image on the page and moves its shelf on, false if it does not fit
+	bool place(AtlasPage& p, int w, int h, SDL_Rect& dst) const;
+
+public:
+
+	TextureAtlas(Window* window_ptr, int page_size=STANDARD_ATLAS_SIZE, int padding=STANDARD_ATLAS_PADDING);
+	virtual ~TextureAtlas();
+
+	//queues an image, it gets packed with the next build
+	void add(const std::string& path);
+	//packs the queued images into the free space of the pages, more pages are added when needed
+	void build();
+
+	bool contains(const std::string& path) const;
+	AtlasSprite get(const std::string& path) const;
+
+	size_t page_count() const;
+	double fill_ratio() const;//packed pixels divided by all page pixels
+
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+};
+
+//IMPLEMENTATION
+AtlasSprite::AtlasSprite(){
+}
+
+AtlasSprite::AtlasSprite(SDL_Texture* page_, Window* window_ptr, const SDL_Rect& clip): page(page_), window(window_ptr), cliprect(clip){
+}
+
+int AtlasSprite::get_width() const{
+	return cliprect.w;
+}
+
+int AtlasSprite::get_height() const{
+	return cliprect.h;
+}
+
+SDL_Texture* AtlasSprite::get_page() const{
+	return page;
+}
+
+const SDL_Rect& AtlasSprite::get_cliprect() const{
+	return cliprect;
+}
+
+void AtlasSprite::set_renderrect(const SDL_Rect& rr){
+	renderrect = rr;
+	has_renderrect = true;
+}
+
+void AtlasSprite::unset_renderrect(){
+	has_renderrect = false;
+}
+
+void AtlasSprite::modulate_color(const uint8_t r, const uint8_t g, const uint8_t b){
+	this->r = r;
+	this->g = g;
+	this->b = b;
+}
+
+void AtlasSprite::set_blendmode(const SDL_BlendMode b){
+	blendmode = b;
+}
+
+const SDL_BlendMode AtlasSprite::get_blendmode() const{
+	return blendmode;
+}
+
+void AtlasSprite::set_alpha(const uint8_t a){
+	alpha = a;
+}
+
+const uint8_t AtlasSprite::get_alpha() const{
+	return alpha;
+}
+
+void AtlasSprite::set_angle(const double a){
+	angle = a;
+}
+
+const double AtlasSprite::get_angle() const{
+	return angle;
+}
+
+void AtlasSprite::rotation_config(const SDL_Point& p, const SDL_RendererFlip f){
+	center = p;
+	has_center = true;
+	flipType = f;
+}
+
+void AtlasSprite::apply_modulation() const{
+	//the page is shared by all sprites on it
+	SDL_SetTextureColorMod(page, r, g, b);
+	SDL_SetTextureBlendMode(page, blendmode);
+	SDL_SetTextureAlphaMod(page, alpha);
+}
+
+void AtlasSprite::draw() const{
+	if (window == nullptr || page == nullptr) return;
+	apply_modulation();
+	SDL_RenderCopyEx(window->renderer, page, &cliprect, has_renderrect ? &renderrect : nullptr, angle, has_center ? &center : nullptr, flipType);
+}
+
+void AtlasSprite::draw(int x, int y, int w, int h) const{
+	if (window == nullptr || page == nullptr) return;
+	if (w == -1) w = cliprect.w;
+	if (h == -1) h = cliprect.h;
+	SDL_Rect rr = {x, y, w, h};
+	apply_modulation();
+	SDL_RenderCopyEx(window->renderer, page, &cliprect, &rr, angle, has_center ? &center : nullptr, flipType);
+}
+
+TextureAtlas::TextureAtlas(Window* window_ptr, int page_size, int padding){
+	this->window = window_ptr;
+	this->page_size = page_size;
+	this->padding = padding;
+}
+
+TextureAtlas::~TextureAtlas(){
+	free_pages();
+}
+
+void TextureAtlas::free_pages(){
+	for (AtlasPage& p : pages) SDL_DestroyTexture(p.texture);
+	pages.clear();
+}
+
+void TextureAtlas::add(const std::string& path){
+	if (regions.find(path) != regions.end()) return;
+	if (std::find(queued.begin(), queued.end(), path) != queued.end()) return;
+	queued.push_back(path);
+}
+
+bool TextureAtlas::contains(const std::string& path) const{
+	return regions.find(path) != regions.end();
+}
+
+bool TextureAtlas::place(AtlasPage& page, int w, int h, SDL_Rect& dst) const{
+
+	int pw = w + padding, ph = h + padding;
+	dst = SDL_Rect{0, 0, w, h};
+
+	if (page.cursor_x + pw <= page.w + padding && page.shelf_y + ph <= page.h + padding && h <= page.shelf_h){
+		dst.x = page.cursor_x;
+		dst.y = page.shelf_y;
+		page.cursor_x += pw;
+		return true;
+	}
+	if (page.shelf_y + page.shelf_h + ph <= page.h + padding && pw <= page.w + padding){
+		page.shelf_y += page.shelf_h;
+		page.shelf_h = ph;
+		dst.x = 0;
+		dst.y = page.shelf_y;
+		page.cursor_x = pw;
+		return true;
+	}
+	return false;
+
+}
+
+void TextureAtlas::build(){
+
+	if (window == nullptr || queued.empty()) return;
+
+	struct Item{
+		std::string path;
+		SDL_Surface* surface;
+	};
+
+	std::vector<Item> items;
+	for (const std::string& path : queued){
+
+		SDL_Surface* s = IMG_Load(path.c_str());
+		if (s == nullptr){
+			std::cout << "Image with path: " << path << " could not be loaded" << std::endl;
+			exit(1);
+		}
+		SDL_Surface* converted = SDL_ConvertSurfaceFormat(s, ATLAS_PIXELFORMAT, 0);
+		SDL_FreeSurface(s);
+		SDL_SetSurfaceBlendMode(converted, SDL_BLENDMODE_NONE);//copying the alpha values, not blending them
+		items.push_back(Item{path, converted});
+
+	}
+	queued.clear();
+
+	//highest images first, that keeps the shelves tight
+	std::sort(items.begin(), items.end(), [](const Item& a, const Item& b){
+		if (a.surface->h != b.surface->h) return a.surface->h > b.surface->h;
+		return a.surface->w > b.surface->w;
+	});
+
+	//pages made in this build are filled on the CPU and uploaded once at the end
+	size_t first_new = pages.size();
+	std::vector<SDL_Surface*> fresh;
+
+	for (Item& item : items){
+
+		int w = item.surface->w, h = item.surface->h;
+
+		size_t placed = pages.size();
+		SDL_Rect dst;
+		for (size_t p = 0; p < pages.size() && placed == pages.size(); p++){
+			if (place(pages[p], w, h, dst)) placed = p;
+		}
+
+		if (placed == pages.size()){
+			//images larger than a page get a page of their own size
+			int size_w = std::max(page_size, w), size_h = std::max(page_size, h);
+			fresh.push_back(SDL_CreateRGBSurfaceWithFormat(0, size_w, size_h, 32, ATLAS_PIXELFORMAT));
+			pages.push_back(AtlasPage{nullptr, size_w, size_h, 0, h + padding, w + padding});
+			dst = SDL_Rect{0, 0, w, h};
+		}
+
+		if (placed >= first_new) SDL_BlitSurface(item.surface, nullptr, fresh[placed - first_new], &dst);
+		else{
+			//pages from an earlier build are already drawn by sprites, only the new part is written
+			uint32_t format;
+			SDL_QueryTexture(pages[placed].texture, &format, nullptr, nullptr, nullptr);
+			SDL_Surface* s = SDL_ConvertSurfaceFormat(item.surface, format, 0);
+			if (s != nullptr) SDL_UpdateTexture(pages[placed].texture, &dst, s->pixels, s->pitch);
+			SDL_FreeSurface(s);
+		}
+
+		regions[item.path] = AtlasRegion{static_cast<unsigned int>(placed), dst};
+		used_area += static_cast<long long>(w) * h;
+
+		SDL_FreeSurface(item.surface);
+
+	}
+
+	for (size_t i = 0; i < fresh.size(); i++){
+		SDL_Texture* t = SDL_CreateTextureFromSurface(window->renderer, fresh[i]);
+		SDL_SetTextureBlendMode(t, STANDARD_BLENDMODE);
+		pages[first_new + i].texture = t;
+		SDL_FreeSurface(fresh[i]);
+	}
+
+}
+
+AtlasSprite TextureAtlas::get(const std::string& path) const{
+
+	auto it = regions.find(path);
+	if (it == regions.end()) return AtlasSprite();
+
+	return AtlasSprite(pages[it->second.page].texture, window, it->second.rect);
+
+}
+
+size_t TextureAtlas::page_count() const{
+	return pages.size();
+}
+
+double TextureAtlas::fill_ratio() const{
+
+	long long total = 0;
+	for (const AtlasPage& p : pages) total += static_cast<long long>(p.w) * p.h;
+
+	if (total == 0) return 0.0;
+	return static_cast<double>(used_area) / total;
+
+}
+
+#endif
@@ -0,0 +1,461 @@
+#ifndef __COLLISION_TREE__
+#define __COLLISION_TREE__
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include "gameobject.h"
+#include "spatial_hash.h"
+
+const int STANDARD_TREE_MARGIN = 8;//pixels the stored bounds reach past the hitboxes
+const int TREE_NULL = -1;
+
+/*
+*
+*	Dynamic bounding volume tree over the bounds of GameObject2D hitboxes.
+*	Unlike the SpatialHash it does not care how different the objects are in size,
+*	a boss hitbox and thousands of bullets fit into the same tree.
+*	Leaves store bounds grown by a margin, so moves of a few pixels do not touch the tree at all.
+*	Only objects leaving their grown bounds are taken out and inserted again.
+*
+*	Example usage:
+*		CollisionTree world;
+*		world.insert(&boss);
+*		for (Bullet& b : bullets) world.insert(&b);
+*		//in the game loop, after moving
+*		world.pairs(collisions);
+*		world.reset_stats();
+*
+*/
+
+struct TreeNode{
+	HitboxBounds box;//grown by the margin for leaves
+	HitboxBounds tight;//bounds of the hitboxes, only for leaves
+	GameObject2D* object;//nullptr for inner nodes
+	int parent, child1, child2;
+	int height;//0 for leaves, -1 for free nodes
+	int next;//next free node
+};
+
+class CollisionTree: public CollisionWorld{
+
+protected:
+
+	std::vector<TreeNode> nodes;
+	int root = TREE_NULL;
+	int free_list = TREE_NULL;
+	int margin = STANDARD_TREE_MARGIN;
+
+	std::unordered_map<GameObject2D*, int> leaves;//object to leaf, TREE_NULL for objects without hitboxes
+	std::vector<int> stack;//for walking the tree without recursion
+
+	unsigned int reinsertions = 0;
+
+	int allocate_node();
+	void free_node(int);
+
+	void insert_leaf(int leaf);
+	void remove_leaf(int leaf);
+	//rotates the subtree at i if one side is more than one higher, gives back the new subtree root
+	int balance(int i);
+	//height and box from the children, walking up to the root
+	void refit(int i);
+
+	static HitboxBounds combine(const HitboxBounds&, const HitboxBounds&);
+	static bool contains(const HitboxBounds& outer, const HitboxBounds& inner);
+	static long long perimeter(const HitboxBounds&);
+
+	//creates the leaf of an object if it has hitboxes
+	void place(GameObject2D*, int& leaf);
+	//every leaf whose stored bounds overlap area, calls found with the leaf
+	template <typename F> void walk(const HitboxBounds& area, F found);
+
+public:
+
+	CollisionTree(int margin=STANDARD_TREE_MARGIN);
+	virtual ~CollisionTree();
+
+	void insert(GameObject2D*);
+	void remove(GameObject2D*);
+	void update(GameObject2D*);
+	void clear();
+
+	//all pairs with overlapping bounds, exact also checks their hitboxes with GameObject2D::hits
+	void pairs(std::vector<CollisionPair>& out, bool exact=true);
+	//objects whose bounds overlap the area
+	void query(const HitboxBounds& area, std::vector<GameObject2D*>& out);
+	//objects that might hit obj, without obj itself
+	void neighbors(GameObject2D* obj, std::vector<GameObject2D*>& out);
+
+	size_t size() const;
+	//height of the root, about log2 of the objects for a balanced tree
+	int get_height() const;
+	//sum of the node perimeters divided by the root perimeter, smaller is better
+	double get_area_ratio() const;
+	//objects that left their grown bounds and were inserted again since the last reset_stats
+	unsigned int get_reinsertions() const;
+	void reset_stats();
+
+	CollisionTree(const CollisionTree&) = delete;
+	CollisionTree& operator=(const CollisionTree&) = delete;
+
+};
+
+//IMPLEMENTATION
+CollisionTree::CollisionTree(int margin){
+	this->margin = (margin >= 0) ? margin : STANDARD_TREE_MARGIN;
+}
+
+CollisionTree::~CollisionTree(){
+	clear();
+}
+
+HitboxBounds CollisionTree::combine(const HitboxBounds& a, const HitboxBounds& b){
+	return HitboxBounds{std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right), std::max(a.bottom, b.bottom)};
+}
+
+bool CollisionTree::contains(const HitboxBounds& outer, const HitboxBounds& inner){
+	return outer.left <= inner.left && outer.top <= inner.top && inner.right <= outer.right && inner.bottom <= outer.bottom;
+}
+
+long long CollisionTree::perimeter(const HitboxBounds& b){
+	return 2LL * (static_cast<long long>(b.right) - b.left + static_cast<long long>(b.bottom) - b.top);
+}
+
+int CollisionTree::allocate_node(){
+
+	if (free_list == TREE_NULL){
+		nodes.push_back(TreeNode());
+		nodes.back().next = TREE_NULL;
+		free_list = static_cast<int>(nodes.size() - 1);
+	}
+
+	int i = free_list;
+	free_list = nodes[i].next;
+
+	TreeNode& n = nodes[i];
+	n.object = nullptr;
+	n.parent = n.child1 = n.child2 = TREE_NULL;
+	n.height = 0;
+	n.next = TREE_NULL;
+	return i;
+
+}
+
+void CollisionTree::free_node(int i){
+	nodes[i].height = -1;
+	nodes[i].object = nullptr;
+	nodes[i].next = free_list;
+	free_list = i;
+}
+
+void CollisionTree::insert_leaf(int leaf){
+
+	if (root == TREE_NULL){
+		root = leaf;
+		nodes[root].parent = TREE_NULL;
+		return;
+	}
+
+	//walks down to the sibling that grows the tree the least (surface area heuristic on perimeters)
+	HitboxBounds box = nodes[leaf].box;
+	int i = root;
+	while (nodes[i].height > 0){
+
+		int c1 = nodes[i].child1, c2 = nodes[i].child2;
+
+		long long area = perimeter(nodes[i].box);
+		long long combined = perimeter(combine(nodes[i].box, box));
+		long long cost = 2 * combined;//new parent of this node and the leaf
+		long long inheritance = 2 * (combined - area);//growing everything below
+
+		long long cost1 = perimeter(combine(box, nodes[c1].box)) + inheritance;
+		if (nodes[c1].height > 0) cost1 -= perimeter(nodes[c1].box);
+		long long cost2 = perimeter(combine(box, nodes[c2].box)) + inheritance;
+		if (nodes[c2].height > 0) cost2 -= perimeter(nodes[c2].box);
+
+		if (cost < cost1 && cost < cost2) break;
+		i = (cost1 < cost2) ? c1 : c2;
+
+	}
+
+	int sibling = i;
+	int old_parent = nodes[sibling].parent;
+	int new_parent = allocate_node();
+	nodes[new_parent].parent = old_parent;
+	nodes[new_parent].box = combine(box, nodes[sibling].box);
+	nodes[new_parent].height = nodes[sibling].height + 1;
+	nodes[new_parent].child1 = sibling;
+	nodes[new_parent].child2 = leaf;
+	nodes[sibling].parent = new_parent;
+	nodes[leaf].parent = new_parent;
+
+	if (old_parent == TREE_NULL) root = new_parent;
+	else if (nodes[old_parent].child1 == sibling) nodes[old_parent].child1 = new_parent;
+	else nodes[old_parent].child2 = new_parent;
+
+	refit(nodes[leaf].parent);
+
+}
+
+void CollisionTree::remove_leaf(int leaf){
+
+	if (leaf == root){
+		root = TREE_NULL;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grand_parent = nodes[parent].parent;
+	int sibling = (nodes[parent].child1 == leaf) ? nodes[parent].child2 : nodes[parent].child1;
+
+	free_node(parent);
+
+	if (grand_parent == TREE_NULL){
+		root = sibling;
+		nodes[sibling].parent = TREE_NULL;
+		return;
+	}
+
+	if (nodes[grand_parent].child1 == parent) nodes[grand_parent].child1 = sibling;
+	else nodes[grand_parent].child2 = sibling;
+	nodes[sibling].parent = grand_parent;
+
+	refit(grand_parent);
+
+}
+
+void CollisionTree::refit(int i){
+
+	while (i != TREE_NULL){
+
+		i = balance(i);
+
+		TreeNode& n = nodes[i];
+		n.height = 1 + std::max(nodes[n.child1].height, nodes[n.child2].height);
+		n.box = combine(nodes[n.child1].box, nodes[n.child2].box);
+
+		i = n.parent;
+
+	}
+
+}
+
+int CollisionTree::balance(int a){
+
+	if (nodes[a].height < 2) return a;
+
+	int b = nodes[a].child1, c = nodes[a].child2;
+	int difference = nodes[c].height - nodes[b].height;
+
+	//rotating the higher child up, its higher child stays below it
+	if (difference > 1 || difference < -1){
+
+		int up = (difference > 1) ? c : b;
+		int low = (difference > 1) ? b : c;
+		int f = nodes[up].child1, g = nodes[up].child2;
+
+		nodes[up].child1 = a;
+		nodes[up].parent = nodes[a].parent;
+		nodes[a].parent = up;
+
+		if (nodes[up].parent == TREE_NULL) root = up;
+		else if (nodes[nodes[up].parent].child1 == a) nodes[nodes[up].parent].child1 = up;
+		else nodes[nodes[up].parent].child2 = up;
+
+		int keep = (nodes[f].height > nodes[g].height) ? f : g;
+		int give = (keep == f) ? g : f;
+
+		nodes[up].child2 = keep;
+		if (difference > 1) nodes[a].child2 = give;
+		else nodes[a].child1 = give;
+		nodes[give].parent = a;
+
+		nodes[a].box = combine(nodes[low].box, nodes[give].box);
+		nodes[a].height = 1 + std::max(nodes[low].height, nodes[give].height);
+		nodes[up].box = combine(nodes[a].box, nodes[keep].box);
+		nodes[up].height = 1 + std::max(nodes[a].height, nodes[keep].height);
+
+		return up;
+
+	}
+
+	return a;
+
+}
+
+void CollisionTree::place(GameObject2D* obj, int& leaf){
+
+	HitboxBounds tight;
+	if (!obj->get_bounds(tight)){
+		leaf = TREE_NULL;
+		return;
+	}
+
+	leaf = allocate_node();
+	TreeNode& n = nodes[leaf];
+	n.object = obj;
+	n.tight = tight;
+	n.box = HitboxBounds{tight.left - margin, tight.top - margin, tight.right + margin, tight.bottom + margin};
+	insert_leaf(leaf);
+
+}
+
+void CollisionTree::insert(GameObject2D* obj){
+
+	if (obj == nullptr || leaves.count(obj) != 0) return;
+	if (obj->get_world() != nullptr) obj->get_world()->remove(obj);
+
+	attach(obj, this);
+	place(obj, leaves[obj]);
+
+}
+
+void CollisionTree::remove(GameObject2D* obj){
+
+	auto it = leaves.find(obj);
+	if (it == leaves.end()) return;
+
+	if (it->second != TREE_NULL){
+		remove_leaf(it->second);
+		free_node(it->second);
+	}
+	leaves.erase(it);
+	attach(obj, nullptr);
+
+}
+
+void CollisionTree::update(GameObject2D* obj){
+
+	auto it = leaves.find(obj);
+	if (it == leaves.end()) return;
+	int& leaf = it->second;
+
+	HitboxBounds tight;
+	bool has_bounds = obj->get_bounds(tight);
+
+	//still inside the grown bounds, the tree stays as it is
+	if (has_bounds && leaf != TREE_NULL && contains(nodes[leaf].box, tight)){
+		nodes[leaf].tight = tight;
+		return;
+	}
+
+	if (leaf != TREE_NULL){
+		remove_leaf(leaf);
+		free_node(leaf);
+		reinsertions += 1;
+	}
+	place(obj, leaf);
+
+}
+
+void CollisionTree::clear(){
+
+	for (auto& l : leaves) attach(l.first, nullptr);
+	leaves.clear();
+	nodes.clear();
+	root = TREE_NULL;
+	free_list = TREE_NULL;
+
+}
+
+template <typename F> void CollisionTree::walk(const HitboxBounds& area, F found){
+
+	if (root == TREE_NULL) return;
+
+	stack.clear();
+	stack.push_back(root);
+	while (!stack.empty()){
+
+		int i = stack.back();
+		stack.pop_back();
+
+		const TreeNode& n = nodes[i];
+		if (!bounds_overlap(n.box, area)) continue;
+
+		if (n.height == 0) found(i);
+		else{
+			stack.push_back(n.child1);
+			stack.push_back(n.child2);
+		}
+
+	}
+
+}
+
+void CollisionTree::pairs(std::vector<CollisionPair>& out, bool exact){
+
+	out.clear();
+
+	for (int a = 0; a < static_cast<int>(nodes.size()); a++){
+
+		if (nodes[a].height != 0) continue;
+		const HitboxBounds tight = nodes[a].tight;
+
+		//every pair is found from both leaves, only the lower index reports it
+		walk(tight, [&](int b){
+			if (b <= a || !bounds_overlap(tight, nodes[b].tight)) return;
+			if (exact && !nodes[a].object->hits(nodes[b].object)) return;
+			out.push_back(CollisionPair(nodes[a].object, nodes[b].object));
+		});
+
+	}
+
+}
+
+void CollisionTree::query(const HitboxBounds& area, std::vector<GameObject2D*>& out){
+
+	out.clear();
+	walk(area, [&](int i){
+		if (bounds_overlap(nodes[i].tight, area)) out.push_back(nodes[i].object);
+	});
+
+}
+
+void CollisionTree::neighbors(GameObject2D* obj, std::vector<GameObject2D*>& out){
+
+	out.clear();
+
+	auto it = leaves.find(obj);
+	if (it == leaves.end() || it->second == TREE_NULL) return;
+
+	const HitboxBounds tight = nodes[it->second].tight;
+	walk(tight, [&](int i){
+		if (nodes[i].object != obj && bounds_overlap(nodes[i].tight, tight)) out.push_back(nodes[i].object);
+	});
+
+}
+
+size_t CollisionTree::size() const{
+	return leaves.size();
+}
+
+int CollisionTree::get_height() const{
+	return (root == TREE_NULL) ? 0 : nodes[root].height;
+}
+
+double CollisionTree::get_area_ratio() const{
+
+	if (root == TREE_NULL) return 0.0;
+
+	long long root_perimeter = perimeter(nodes[root].box);
+	if (root_perimeter <= 0) return 0.0;
+
+	long long total = 0;
+	for (const TreeNode& n : nodes){
+		if (n.height >= 0) total += perimeter(n.box);
+	}
+	return static_cast<double>(total) / root_perimeter;
+
+}
+
+unsigned int CollisionTree::get_reinsertions() const{
+	return reinsertions;
+}
+
+void CollisionTree::reset_stats(){
+	reinsertions = 0;
+}
+
+#endif
@@ -18,9 +18,14 @@
 #include <iostream>
 #include <string>
 #include <cinttypes>
+#include <cmath>
 #include <exception>
 
 #include "texture.h"
+#include "glyphatlas.h"
+#include "sdffont.h"
+#include "fontcache.h"
+#include "textlayout.h"
 
 const SDL_Color DEFAULT_COLOR {0x0, 0x0, 0x0};//black
 const int DEFAULT_FONT_SIZE = 28;
@@ -35,6 +40,28 @@ protected:
 	TTF_Font* font = nullptr;
 	int fontsize = DEFAULT_FONT_SIZE;
 
+	//in glyph mode the text is drawn out of a shared GlyphAtlas instead of an own texture
+	GlyphAtlas* glyphs = nullptr;
+	//in sdf mode the text is drawn out of one distance field font for all sizes, font stays nullptr
+	SdfFont* sdf = nullptr;
+
+	//wrapped text is laid out by mainTextLayout, 0 means no wrapping
+	int wrap_width = 0;
+	TextAlign align = ALIGN_LEFT;
+	Paragraph paragraph;
+
+	//the key under which the rendered text is stored in the TextureCache
+	std::string cache_key() const;
+	//color and alpha of the glyph quads
+	SDL_Color glyph_color() const;
+	//all lines of the wrapped text in one surface
+	SDL_Surface* render_paragraph() const;
+	//copies everything besides the Texture part and the font handles
+	void copy_text_state(const Font&);
+	//opens what the given modes draw with, release_fonts gives all of it back
+	void acquire_fonts(bool glyph_mode, bool sdf_mode);
+	void release_fonts();
+
 public:
 
 	Font();
@@ -50,11 +77,30 @@ public:
 	void set_color(const SDL_Color& c);
 	void set_font(const std::string& f, int fs=DEFAULT_FONT_SIZE);
 
-	Font& operator=(Font&&);
-	Font& operator=(Font&);
+	//for text that changes often, like scores and timers: changing the text costs no rendering
+	void set_glyph_mode(bool);
+	bool is_glyph_mode() const;
+	//for text that is zoomed or resized often: changing the size opens no font and renders nothing
+	void set_sdf_mode(bool);
+	bool is_sdf_mode() const;
+
+	//wraps the text at spaces so no line is wider than max_width, 0 turns wrapping off
+	void set_wrap(int max_width, TextAlign a=ALIGN_LEFT);
+	const Paragraph& get_paragraph() const;
+
+	void draw() const;
+	void draw(int x, int y, int w=-1, int h=-1) const;
+	//adds the text to a batch, in glyph mode only the glyph quads
+	void draw(SpriteBatch& batch, int x, int y) const;
+
+	//a copy with its own texture, the text is not rendered again
+	Font clone() const;
+
+	Font& operator=(Font&&) noexcept;
+	Font& operator=(const Font&);
 
 	Font(const Font&);
-	Font(const Font&&);
+	Font(Font&&) noexcept;
 
 };
 
@@ -69,9 +115,10 @@ Font::Font(const std::string& path, Window* w, const std::string& text, const SD
 	this->filepath = path;
 	this->text = text;
 	this->color = c;
+	this->fontsize = fs;
 	this->window = w;
 
-	font = TTF_OpenFont(path.c_str(), fontsize);
+	font = FontCache::instance().acquire(path, fontsize);
 
 	load_image(text);
 
@@ -81,19 +128,20 @@ Font::Font(const std::string& path, Window* w, const std::string& text, const SD
 	set_cliprect(clip);
 	set_renderrect(rend);
 	this->path = path;
+	this->filepath = path;
 	this->text = text;
 	this->color = c;
 	this->fontsize = fs;
 	this->window = w;
 
-	font = TTF_OpenFont(path.c_str(), fontsize);
+	font = FontCache::instance().acquire(path, fontsize);
 
 	load_image(text);
 }
 
 Font::~Font(){
 
-	if (font != nullptr) TTF_CloseFont(font);
+	release_fonts();
 
 }
 
@@ -105,19 +153,44 @@ void Font::load_image(const std::string& text, bool reload){
 	}
 
 	if(window == nullptr) return;
-	if (texture != nullptr) SDL_DestroyTexture(texture);
 
+	if (reload){
+		Texture::load_image(filepath, true);
+		return;
+	}
 
-	SDL_Surface* s;
+	free_texture();
 
-	if (!reload){
+	if (sdf != nullptr){
+		//laid out at the base size of the field and scaled to the font size
+		float scale = static_cast<float>(fontsize) / SDF_BASE_SIZE;
+		if (wrap_width > 0){
+			paragraph = mainTextLayout.layout(sdf->get_font(), text, static_cast<int>(wrap_width / scale), align);
+			width = static_cast<int>(std::ceil(paragraph.width * scale));
+			height = static_cast<int>(std::ceil(paragraph.height * scale));
+		}
+		else sdf->measure(text, static_cast<float>(fontsize), width, height);
+		return;
+	}
 
-		if(pixelSurface != nullptr) SDL_FreeSurface(pixelSurface);
+	if (wrap_width > 0) paragraph = mainTextLayout.layout(font, text, wrap_width, align);
 
-		s = TTF_RenderText_Solid(font, text.c_str(), color);
-		if(window != nullptr){
-			pixelSurface = SDL_ConvertSurfaceFormat(s, SDL_GetWindowPixelFormat(window->window), 0);
+	if (glyphs != nullptr){
+		if (wrap_width > 0){
+			width = paragraph.width;
+			height = paragraph.height;
 		}
+		else glyphs->measure(text, width, height);
+		return;
+	}
+
+	//labels with the same font, color and text share one texture
+	std::string key = cache_key();
+	CachedTexture* entry = TextureCache::instance().find(key, window->renderer, residency);
+
+	if (entry == nullptr){
+
+		SDL_Surface* s = (wrap_width > 0) ? render_paragraph() : TTF_RenderText_Solid(font, text.c_str(), color);
 
 		if(s == nullptr) {
 
@@ -125,33 +198,100 @@ void Font::load_image(const std::string& text, bool reload){
 			exit(1);
 		}
 
-		width = s->w;
-		height = s->h;
+		SDL_Surface* converted = SDL_ConvertSurfaceFormat(s, SDL_GetWindowPixelFormat(window->window), 0);
+		SDL_Texture* t = SDL_CreateTextureFromSurface(window->renderer, converted);
+
+		entry = TextureCache::instance().insert(key, window->renderer, t, converted, s->w, s->h, residency);
+		SDL_FreeSurface(s);
 
 	}
 
+	attach(entry);
+
+
+}
+
+std::string Font::cache_key() const{
+
+	std::string key = "ttf:" + filepath + ":" + std::to_string(fontsize) + ":" + std::to_string(color.r) + "," + std::to_string(color.g) + "," + std::to_string(color.b);
+	if (wrap_width > 0) key += ":wrap" + std::to_string(wrap_width) + "," + std::to_string(align);
+	return key + ":" + text;
+
+}
+
+SDL_Color Font::glyph_color() const{
+
+	SDL_Color c;
+	c.r = static_cast<uint8_t>(color.r * r / 255);
+	c.g = static_cast<uint8_t>(color.g * g / 255);
+	c.b = static_cast<uint8_t>(color.b * b / 255);
+	c.a = alpha;
+	return c;
+
+}
+
+SDL_Surface* Font::render_paragraph() const{
+
+	SDL_Surface* s = SDL_CreateRGBSurfaceWithFormat(0, std::max(paragraph.width, 1), std::max(paragraph.height, 1), 32, SDL_PIXELFORMAT_ARGB8888);
+	if (s == nullptr) return nullptr;
+	SDL_FillRect(s, nullptr, 0);//transparent
+
+	for (const LayoutLine& line : paragraph.lines){
+
+		if (line.text.empty()) continue;
+		SDL_Surface* rendered = TTF_RenderUTF8_Solid(font, line.text.c_str(), color);
+		if (rendered == nullptr) continue;
+
+		SDL_Rect dst = {line.x, line.y, rendered->w, rendered->h};
+		SDL_BlitSurface(rendered, nullptr, s, &dst);
+		SDL_FreeSurface(rendered);
 
-	texture = SDL_CreateTextureFromSurface(window->renderer, pixelSurface);
-	if(!reload){
-		SDL_FreeSurface(s);
 	}
 
-	set_blendmode(blendmode);
-	set_alpha(alpha);
+	return s;
+
+}
+
+void Font::copy_text_state(const Font& f){
+	text = f.text;
+	color = f.color;
+	fontsize = f.fontsize;
+	wrap_width = f.wrap_width;
+	align = f.align;
+	paragraph = f.paragraph;
+}
+
+void Font::acquire_fonts(bool glyph_mode, bool sdf_mode){
+
+	if (sdf_mode) sdf = SdfFont::acquire(filepath, window);
+	else font = FontCache::instance().acquire(filepath, fontsize);
+	if (glyph_mode) glyphs = GlyphAtlas::acquire(filepath, fontsize, window);
+
+}
+
+void Font::release_fonts(){
 
+	FontCache::instance().release(font);
+	GlyphAtlas::release(glyphs);
+	SdfFont::release(sdf);
+	font = nullptr;
+	glyphs = nullptr;
+	sdf = nullptr;
 
 }
 
 void Font::load(const std::string& path, Window* w, const std::string& text, const SDL_Color& c, const int fs){
 
+	bool glyph_mode = (glyphs != nullptr), sdf_mode = (sdf != nullptr);
+	release_fonts();
+
 	this->filepath = path;
 	this->text = text;
 	this->color = c;
 	this->fontsize = fs;
 	this->window = w;
 
-
-	font = TTF_OpenFont(path.c_str(), fontsize);
+	acquire_fonts(glyph_mode, sdf_mode);
 
 	load_image(text);
 }
@@ -176,36 +316,181 @@ void Font::set_color(const SDL_Color& c){
 
 void Font::set_font(const std::string& path, int fs){
 
+	//a distance field font serves every size of its file
+	if (sdf != nullptr && path == filepath){
+		fontsize = fs;
+		load_image(text);
+		return;
+	}
+
+	bool glyph_mode = (glyphs != nullptr), sdf_mode = (sdf != nullptr);
+	release_fonts();
+
 	this->filepath = path;
 	this->fontsize = fs;
 
-	if(font != nullptr) TTF_CloseFont(font);
+	acquire_fonts(glyph_mode, sdf_mode);
 
-	font = TTF_OpenFont(path.c_str(), fontsize);
+	load_image(text);
 
+}
+
+void Font::set_glyph_mode(bool enabled){
+
+	if (enabled == (glyphs != nullptr) || window == nullptr) return;
+
+	//glyph and sdf mode exclude each other
+	release_fonts();
+	acquire_fonts(enabled, false);
+
+	load_image(text);
+
+}
+
+bool Font::is_glyph_mode() const{
+	return glyphs != nullptr;
+}
+
+void Font::set_sdf_mode(bool enabled){
+
+	if (enabled == (sdf != nullptr) || window == nullptr) return;
+
+	release_fonts();
+	acquire_fonts(false, enabled);
+
+	load_image(text);
+
+}
+
+bool Font::is_sdf_mode() const{
+	return sdf != nullptr;
+}
+
+void Font::set_wrap(int max_width, TextAlign a){
+
+	wrap_width = max_width;
+	align = a;
+	if (wrap_width <= 0) paragraph = Paragraph();
 	load_image(text);
 
 }
 
-Font& Font::operator=(Font&& f){
+const Paragraph& Font::get_paragraph() const{
+	return paragraph;
+}
+
+void Font::draw() const{
+
+	if (glyphs == nullptr && sdf == nullptr){
+		Texture::draw();
+		return;
+	}
+
+	if (renderrect != nullptr) draw(renderrect->x, renderrect->y, renderrect->w, renderrect->h);
+	else draw(0, 0);
+
+}
+
+void Font::draw(int x, int y, int w, int h) const{
+
+	if (glyphs == nullptr && sdf == nullptr){
+		Texture::draw(x, y, w, h);
+		return;
+	}
+
+	//glyphs keep their aspect ratio, the width decides the scale
+	float scale = (w != -1 && width > 0) ? static_cast<float>(w) / width : 1.0f;
+	if (sdf != nullptr){
+		if (wrap_width > 0) sdf->draw(paragraph, x, y, fontsize * scale, glyph_color(), blendmode);
+		else sdf->draw(text, x, y, fontsize * scale, glyph_color(), blendmode);
+		return;
+	}
+	if (wrap_width > 0) glyphs->draw(paragraph, x, y, glyph_color(), scale, blendmode);
+	else glyphs->draw(text, x, y, glyph_color(), scale, blendmode);
+
+}
+
+void Font::draw(SpriteBatch& batch, int x, int y) const{
+
+	if (sdf != nullptr){
+		if (wrap_width > 0) sdf->add(batch, paragraph, static_cast<float>(x), static_cast<float>(y), static_cast<float>(fontsize), glyph_color(), blendmode);
+		else sdf->add(batch, text, static_cast<float>(x), static_cast<float>(y), static_cast<float>(fontsize), glyph_color(), blendmode);
+		return;
+	}
+
+	if (glyphs == nullptr){
+		batch.add(*this, x, y);
+		return;
+	}
+
+	if (wrap_width > 0) glyphs->add(batch, paragraph, static_cast<float>(x), static_cast<float>(y), glyph_color(), 1.0f, blendmode);
+	else glyphs->add(batch, text, static_cast<float>(x), static_cast<float>(y), glyph_color(), 1.0f, blendmode);
+
+}
+
+Font Font::clone() const{
+
+	Font copy;
+	copy.copy_state(*this);
+	duplicate_data(copy);
+	copy.copy_text_state(*this);
+	copy.acquire_fonts(glyphs != nullptr, sdf != nullptr);
+	return copy;
+
+}
 
-	load(f.filepath, f.window, f.text, f.color, f.fontsize);
+Font& Font::operator=(Font&& f) noexcept{
+
+	if (this != &f){
+		release_fonts();
+		Texture::operator=(std::move(f));
+		font = f.font;
+		text = std::move(f.text);
+		color = f.color;
+		fontsize = f.fontsize;
+		wrap_width = f.wrap_width;
+		align = f.align;
+		paragraph = std::move(f.paragraph);
+		glyphs = f.glyphs;
+		sdf = f.sdf;
+		f.font = nullptr;
+		f.glyphs = nullptr;
+		f.sdf = nullptr;
+	}
 
 	return (*this);
 }
 
-Font& Font::operator=(Font& f){
+Font& Font::operator=(const Font& f){
 
-	load(f.filepath, f.window, f.text, f.color, f.fontsize);
+	if (this != &f){
+		release_fonts();
+		//the rendered text and the font are shared through the caches
+		Texture::operator=(f);
+		copy_text_state(f);
+		acquire_fonts(f.glyphs != nullptr, f.sdf != nullptr);
+	}
 
 	return (*this);
 }
 
-Font::Font(const Font& f){
-	load(f.filepath, f.window, f.text, f.color, f.fontsize);
+Font::Font(const Font& f): Texture(f){
+	copy_text_state(f);
+	acquire_fonts(f.glyphs != nullptr, f.sdf != nullptr);
 }
-Font::Font(const Font&& f){
-	load(f.filepath, f.window, f.text, f.color, f.fontsize);
+Font::Font(Font&& f) noexcept: Texture(std::move(f)){
+	font = f.font;
+	text = std::move(f.text);
+	color = f.color;
+	fontsize = f.fontsize;
+	wrap_width = f.wrap_width;
+	align = f.align;
+	paragraph = std::move(f.paragraph);
+	glyphs = f.glyphs;
+	sdf = f.sdf;
+	f.font = nullptr;
+	f.glyphs = nullptr;
+	f.sdf = nullptr;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,174 @@
+#ifndef __FONTCACHE__
+#define __FONTCACHE__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <functional>
+#include <unordered_map>
+
+/*
+*
+*	Process wide cache for opened fonts. Every (path, point size) is opened once,
+*	all Font objects using it share the TTF_Font, which is closed when the last user releases it.
+*
+*	Example usage:
+*		TTF_Font* font = FontCache::instance().acquire("PATH.ttf", 28);
+*		//rendering with font
+*		FontCache::instance().release(font);
+*
+*	Shared fonts must not get a style or outline set, that would change them for every user.
+*
+*/
+
+struct FontKey{
+
+	std::string path;
+	int size;
+
+	bool operator==(const FontKey& other) const{
+		return size == other.size && path == other.path;
+	}
+
+};
+
+struct FontKeyHash{
+
+	size_t operator()(const FontKey& k) const{
+		size_t h = std::hash<std::string>()(k.path);
+		return h ^ (std::hash<int>()(k.size) + 0x9e3779b9 + (h << 6) + (h >> 2));
+	}
+
+};
+
+struct CachedFont{
+	FontKey key;
+	TTF_Font* font = nullptr;
+	unsigned int references = 0;
+};
+
+class FontCache{
+
+protected:
+
+	std::unordered_map<FontKey, CachedFont*, FontKeyHash> entries;
+	std::unordered_map<TTF_Font*, CachedFont*> by_font;//for releasing by the handle alone
+
+	unsigned int opens = 0;
+
+	FontCache();
+
+public:
+
+	static FontCache& instance();
+
+	virtual ~FontCache();
+
+	//gives back the opened font, opening the file only if nobody uses it yet. nullptr if it could not be opened
+	TTF_Font* acquire(const std::string& path, int size);
+	//drops one reference, the font is closed when nobody uses it anymore
+	void release(TTF_Font*);
+	//the path and size the font was opened with, false for fonts not opened through the cache
+	bool get_key(TTF_Font*, FontKey& key) const;
+
+	size_t size() const;
+	//how often a font file was actually opened
+	unsigned int get_opens() const;
+
+	FontCache(const FontCache&) = delete;
+	FontCache& operator=(const FontCache&) = delete;
+
+};
+
+FontCache::FontCache(){
+}
+
+FontCache& FontCache::instance(){
+	static FontCache cache;
+	return cache;
+}
+
+FontCache::~FontCache(){
+
+	//TTF_Quit most likely already ran, so only the bookkeeping is freed
+	for (auto& e : entries) delete e.second;
+
+}
+
+TTF_Font* FontCache::acquire(const std::string& path, int size){
+
+	auto it = entries.find(FontKey{path, size});
+	if (it != entries.end()){
+		it->second->references += 1;
+		return it->second->font;
+	}
+
+	TTF_Font* font = TTF_OpenFont(path.c_str(), size);
+	if (font == nullptr){
+		std::cout << "Font with path: " << path << " could not be loaded" << std::endl;
+		return nullptr;
+	}
+	opens += 1;
+
+	CachedFont* entry = new CachedFont;
+	entry->key = FontKey{path, size};
+	entry->font = font;
+	entry->references = 1;
+
+	entries[entry->key] = entry;
+	by_font[font] = entry;
+	return font;
+
+}
+
+void FontCache::release(TTF_Font* font){
+
+	if (font == nullptr) return;
+
+	auto it = by_font.find(font);
+	if (it == by_font.end()) return;
+
+	CachedFont* entry = it->second;
+	if (entry->references > 1){
+		entry->references -= 1;
+		return;
+	}
+
+	by_font.erase(it);
+	entries.erase(entry->key);
+	TTF_CloseFont(entry->font);
+	delete entry;
+
+}
+
+bool FontCache::get_key(TTF_Font* font, FontKey& key) const{
+
+	auto it = by_font.find(font);
+	if (it == by_font.end()) return false;
+
+	key = it->second->key;
+	return true;
+
+}
+
+size_t FontCache::size() const{
+	return entries.size();
+}
+
+unsigned int FontCache::get_opens() const{
+	return opens;
+}
+
+#endif
@@ -4,22 +4,58 @@
 
 #include "hitbox.h"
 #include <vector>
+#include <algorithm>
+#include <cmath>
 
 typedef void(*wrap_f_t)(void*);//primitive draw function
 
+class GameObject2D;
+
+//broad phase the objects tell about changed hitboxes, so it does not need to check every object each frame
+class CollisionWorld{
+
+protected:
+
+	//for implementations, they can not reach into GameObject2D themselves
+	static void attach(GameObject2D*, CollisionWorld*);
+
+public:
+
+	virtual void insert(GameObject2D*)=0;
+	virtual void remove(GameObject2D*)=0;
+	//called by the object whenever its hitboxes moved, changed size or were added and removed
+	virtual void update(GameObject2D*)=0;
+	//objects whose bounds overlap the area
+	virtual void query(const HitboxBounds& area, std::vector<GameObject2D*>& out)=0;
+	virtual ~CollisionWorld(){}
+
+};
+
 class GameObject2D{//virtual class, should only be inherited
 
+	friend class CollisionWorld;
+
 protected:
 
 	double x=0, y=0;//double for correct positioning
 	double w=0, h=0;//for width and height
 	
-	std::vector<Hitbox*> hitboxes;//pointer to hitboxes
+	HitboxList shapes;//hitboxes stored by value, no allocation for the first INLINE_HITBOXES
+	std::vector<Hitbox*> hitboxes;//pointer to hitboxes made with new, owned by the object
 
 	bool update_on_move = true;
 
 	wrap_f_t draw_f;
 
+	CollisionWorld* world = nullptr;//the world the object is inserted into
+
+	//deletes the own hitboxes and adds copies of the ones of other
+	void copy_hitboxes(const GameObject2D& other);
+	//moves the hitboxes without telling the world, for trying out a position
+	void offset_hitboxes(int xdelta, int ydelta);
+	//the earliest contact of moving with its hitboxes, found tells if out already holds one
+	bool first_contact(const HitboxShape& moving, double dx, double dy, bool found, SweepHit& out) const;
+
 
 
 
@@ -42,16 +78,35 @@ public:
 	int H() const;
 
 	bool hits(GameObject2D*);//checks if it hits other game object
+	bool hits(const HitboxShape&) const;//checks if one of its hitboxes hits the shape
+	//first contact of its hitboxes when moving by dx, dy while other stands still
+	bool sweep(GameObject2D* other, double dx, double dy, SweepHit& out);
+	//moves by dx, dy but stops where it first touches one of others, true if it was stopped
+	//objects it already hits do not stop it, so it can move out of them, it never ends up in any other one
+	//hit gets the part of the move that was done and the normal of the object that stopped it
+	bool move_swept(double dx, double dy, const std::vector<GameObject2D*>& others, SweepHit* hit=nullptr);
+	//the same against the objects of its world
+	bool move_swept(double dx, double dy, SweepHit* hit=nullptr);
 	void draw(void*) const;
 	void set_draw_f(wrap_f_t f);
 
+	//hitboxes by value, gives back the index in get_shapes
+	size_t add_hitbox(const HitboxShape&);
+	void remove_shape(size_t);
+	HitboxList* get_shapes();//changes to the list reach a world with update_hitboxes()
+
+	//hitboxes made with new, each one is allocated, the value hitboxes above are faster
 	Hitbox* add_hitbox(int x, int y, int wr=0, int h=0, HitboxType ht = HitboxType::RECTANGULAR);//wr stands for width and radius, for both
-	void remove_hitbox(Hitbox*);
-	void set_hitboxes(std::vector<Hitbox*>);//sets all given hitboxes to the new pointer
-	std::vector<Hitbox*>* get_hitboxes();
+	void remove_hitbox(Hitbox*);//the hitbox is not deleted, it belongs to the caller again
+	void set_hitboxes(std::vector<Hitbox*>);//deletes the old hitboxes and removes the value ones, the object owns the given ones, they have to be made with new
+	std::vector<Hitbox*>* get_hitboxes();//hitboxes added to the vector belong to the object, tell a world with update_hitboxes()
 
 	void update_hitboxes(int xdelta=0, int ydelta=0, int wdelta=0, int hdelta=0);// updates all hitboxes accordingly, for circular hitboxes wdelta is radius change
 
+	//the bounds around all hitboxes, false if there are none
+	bool get_bounds(HitboxBounds&) const;
+	CollisionWorld* get_world() const;
+
 	GameObject2D(double, double, double, double, wrap_f_t draw, bool update=true);//for initialization
 	GameObject2D(const GameObject2D&);
 	GameObject2D(const GameObject2D&&);
@@ -66,6 +121,7 @@ public:
 GameObject2D::GameObject2D(double x_, double y_, double w_, double h_, wrap_f_t draw, bool update): x(x_), y(y_), w(w_), h(h_), draw_f(draw), update_on_move(update){}
 GameObject2D::~GameObject2D(){
 
+	if (world != nullptr) world->remove(this);
 	for(Hitbox* ht : (hitboxes)) delete ht;
 
 }
@@ -89,19 +145,19 @@ void GameObject2D::changeX(double x_){
 }
 void GameObject2D::changeY(double y_){
 	if(update_on_move){
-		update_hitboxes(y_ - y, 0);
+		update_hitboxes(0, y_ - y);
 	}
 	y = y_;
 }
 void GameObject2D::changeW(double w_){
 	if(update_on_move){
-		update_hitboxes(0, w_-w);
+		update_hitboxes(0, 0, w_-w);
 	}
 	w = w_;
 }
 void GameObject2D::changeH(double h_){
 	if(update_on_move){
-		update_hitboxes(0, h_-h);
+		update_hitboxes(0, 0, 0, h_-h);
 	}
 	h = h_;
 }
@@ -109,29 +165,167 @@ void GameObject2D::changeH(double h_){
 
 bool GameObject2D::hits(GameObject2D* other){
 	
+	for(size_t i = 0; i < shapes.size(); i++){
+		if (other->hits(shapes[i])) return true;
+	}
 	for(Hitbox* h : (hitboxes)){
+		if (other->hits(h->shape())) return true;
+	}
+
+	return false;
 
-		for(Hitbox* oh : ((other->hitboxes))){
+}
 
-			if (h->hits(oh)) return true;
-		}
+bool GameObject2D::hits(const HitboxShape& shape) const{
 
+	for(size_t i = 0; i < shapes.size(); i++){
+		if (shape.hits(shapes[i])) return true;
+	}
+	for(Hitbox* oh : (hitboxes)){
+		if (shape.hits(oh->shape())) return true;
 	}
 
 	return false;
 
 }
 
+bool GameObject2D::first_contact(const HitboxShape& moving, double dx, double dy, bool found, SweepHit& out) const{
+
+	SweepHit sh;
+	for(size_t i = 0; i < shapes.size(); i++){
+		if (!moving.sweep(shapes[i], dx, dy, sh)) continue;
+		if (!found || sh.time < out.time) out = sh;
+		found = true;
+	}
+	for(Hitbox* oh : (hitboxes)){
+		if (!moving.sweep(oh->shape(), dx, dy, sh)) continue;
+		if (!found || sh.time < out.time) out = sh;
+		found = true;
+	}
+
+	return found;
+
+}
+
+bool GameObject2D::sweep(GameObject2D* other, double dx, double dy, SweepHit& out){
+
+	bool found = false;
+	for(size_t i = 0; i < shapes.size(); i++) found = other->first_contact(shapes[i], dx, dy, found, out);
+	for(Hitbox* h : (hitboxes)) found = other->first_contact(h->shape(), dx, dy, found, out);
+
+	return found;
+
+}
+
+bool GameObject2D::move_swept(double dx, double dy, const std::vector<GameObject2D*>& others, SweepHit* hit){
+
+	SweepHit first = SweepHit{1, 0, 0};
+	bool stopped = false;
+	std::vector<GameObject2D*> inside;//objects it already hits
+
+	for (GameObject2D* o : others){
+
+		SweepHit sh;
+		if (o == nullptr || o == this || !sweep(o, dx, dy, sh)) continue;
+		//time 0 without a normal means they already hit
+		if (sh.time == 0 && sh.nx == 0 && sh.ny == 0){
+			inside.push_back(o);
+			continue;
+		}
+		if (stopped && sh.time >= first.time) continue;
+
+		first = sh;
+		stopped = true;
+
+	}
+
+	double t = first.time;
+
+	if (update_on_move){
+
+		//the hitboxes follow the whole pixels of x and y, so they do not drift away from X() and Y()
+		//rounding can still put them into an object, then the move goes back a pixel at a time until nothing new is hit
+		double step = 1.0 / std::max(std::max(std::fabs(dx), std::fabs(dy)), 1.0);
+		int ix = 0, iy = 0;
+		while (true){
+
+			ix = static_cast<int>(x + dx * t) - static_cast<int>(x);
+			iy = static_cast<int>(y + dy * t) - static_cast<int>(y);
+			if (t <= 0 || (ix == 0 && iy == 0)) break;
+
+			offset_hitboxes(ix, iy);
+			bool blocked = false;
+			for (GameObject2D* o : others){
+				if (o == nullptr || o == this || std::find(inside.begin(), inside.end(), o) != inside.end()) continue;
+				if (hits(o)){
+					blocked = true;
+					break;
+				}
+			}
+			offset_hitboxes(-ix, -iy);
+			if (!blocked) break;
+
+			t = std::max(t - step, 0.0);
+			stopped = true;
+
+		}
+		update_hitboxes(ix, iy);
+
+	}
+
+	x += dx * t;
+	y += dy * t;
+
+	first.time = t;
+	if (hit != nullptr) *hit = first;
+	return stopped;
+
+}
+
+bool GameObject2D::move_swept(double dx, double dy, SweepHit* hit){
+
+	std::vector<GameObject2D*> near;
+	HitboxBounds b;
+	if (world != nullptr && get_bounds(b)){
+
+		//everything the bounds pass on the way
+		HitboxBounds area = {b.left + static_cast<int>(std::floor(std::min(dx, 0.0))) - 1, b.top + static_cast<int>(std::floor(std::min(dy, 0.0))) - 1,
+							b.right + static_cast<int>(std::ceil(std::max(dx, 0.0))) + 1, b.bottom + static_cast<int>(std::ceil(std::max(dy, 0.0))) + 1};
+		world->query(area, near);
+
+	}
+	return move_swept(dx, dy, near, hit);
+
+}
+
 void GameObject2D::set_hitboxes(std::vector<Hitbox*> ht){
 	
+	shapes.clear();
 	for (Hitbox* h : (hitboxes)) delete h;
 	hitboxes = ht;
+	if (world != nullptr) world->update(this);
 }
 
 std::vector<Hitbox*>* GameObject2D::get_hitboxes(){
 	return &hitboxes;
 }
 
+size_t GameObject2D::add_hitbox(const HitboxShape& shape){
+	shapes.push_back(shape);
+	if (world != nullptr) world->update(this);
+	return shapes.size() - 1;
+}
+
+void GameObject2D::remove_shape(size_t i){
+	if (i >= shapes.size()) return;
+	shapes.erase(i);
+	if (world != nullptr) world->update(this);
+}
+
+HitboxList* GameObject2D::get_shapes(){
+	return &shapes;
+}
+
 Hitbox* GameObject2D::add_hitbox(int x, int y, int wr, int h, HitboxType ht){
 
 
@@ -139,16 +333,19 @@ Hitbox* GameObject2D::add_hitbox(int x, int y, int wr, int h, HitboxType ht){
 
 		case HitboxType::RECTANGULAR: 	{
 											RectangularHitbox* rh = new RectangularHitbox(x, y, wr, h);
-											hitboxes.push_back(dynamic_cast<Hitbox*>(rh));
-											return dynamic_cast<Hitbox*>(rh);
+											hitboxes.push_back(rh);
+											if (world != nullptr) world->update(this);
+											return rh;
 											break;
 										}	  
 		case HitboxType::CIRCULAR:		{
 											CircularHitbox* ch = new CircularHitbox(x, y, wr);
-											hitboxes.push_back(dynamic_cast<Hitbox*>(ch));
-											return dynamic_cast<Hitbox*>(ch);
+											hitboxes.push_back(ch);
+											if (world != nullptr) world->update(this);
+											return ch;
 											break;
 										}
+		default: break;
 
 	}
 
@@ -161,18 +358,22 @@ void GameObject2D::remove_hitbox(Hitbox* hb){
 	while (it != hitboxes.end() && (*it) != hb){
 		it++;
 	}
-	if (it != hitboxes.end()) hitboxes.erase(it);
+	if (it == hitboxes.end()) return;
+	hitboxes.erase(it);
+	if (world != nullptr) world->update(this);
 
 }
 
 void GameObject2D::update_hitboxes(int xdelta, int ydelta, int wdelta, int hdelta){
 
+	for(size_t i = 0; i < shapes.size(); i++) shapes[i].update(xdelta, ydelta, wdelta, hdelta);
+
 	for(Hitbox* h : (hitboxes)){
 
 		switch(h->type){
 
 			case HitboxType::RECTANGULAR: 	{
-											RectangularHitbox* rh = dynamic_cast<RectangularHitbox*>(h);
+											RectangularHitbox* rh = static_cast<RectangularHitbox*>(h);
 											rh->x += xdelta;
 											rh->y += ydelta;
 											rh->w += wdelta;
@@ -180,18 +381,90 @@ void GameObject2D::update_hitboxes(int xdelta, int ydelta, int wdelta, int hdelt
 											break;
 											}
 			case HitboxType::CIRCULAR:		{
-											CircularHitbox* ch = dynamic_cast<CircularHitbox*>(h);
+											CircularHitbox* ch = static_cast<CircularHitbox*>(h);
 											ch->x += xdelta;
 											ch->y += ydelta;
 											ch->r += (wdelta >> 1);
 											break;
 											}
+			default: break;
 		}
 
 	}
 
+	if (world != nullptr) world->update(this);
+
 }
 
+void GameObject2D::offset_hitboxes(int xdelta, int ydelta){
+
+	for(size_t i = 0; i < shapes.size(); i++) shapes[i].update(xdelta, ydelta);
+	for(Hitbox* h : (hitboxes)){
+		if (h->type == HitboxType::RECTANGULAR){
+			RectangularHitbox* rh = static_cast<RectangularHitbox*>(h);
+			rh->x += xdelta;
+			rh->y += ydelta;
+		}
+		else if (h->type == HitboxType::CIRCULAR){
+			CircularHitbox* ch = static_cast<CircularHitbox*>(h);
+			ch->x += xdelta;
+			ch->y += ydelta;
+		}
+	}
+
+}
+
+bool GameObject2D::get_bounds(HitboxBounds& b) const{
+
+	bool found = false;
+	size_t count = shapes.size() + hitboxes.size();
+	for (size_t i = 0; i < count; i++){
+
+		HitboxBounds hb = (i < shapes.size()) ? shapes[i].bounds() : hitbox_bounds(hitboxes[i - shapes.size()]);
+		if (!found){
+			b = hb;
+			found = true;
+			continue;
+		}
+		b.left = std::min(b.left, hb.left);
+		b.top = std::min(b.top, hb.top);
+		b.right = std::max(b.right, hb.right);
+		b.bottom = std::max(b.bottom, hb.bottom);
+	}
+	return found;
+
+}
+
+CollisionWorld* GameObject2D::get_world() const{
+	return world;
+}
+
+void CollisionWorld::attach(GameObject2D* obj, CollisionWorld* w){
+	obj->world = w;
+}
+
+
+void GameObject2D::copy_hitboxes(const GameObject2D& other){
+
+	if (&other == this) return;
+
+	shapes = other.shapes;
+
+	for(Hitbox* h : hitboxes) delete h;
+	hitboxes.clear();
+
+	for(Hitbox* h : other.hitboxes){
+		if (h->type == HitboxType::RECTANGULAR){
+			RectangularHitbox* hr = static_cast<RectangularHitbox*>(h);
+			hitboxes.push_back(new RectangularHitbox(hr->x, hr->y, hr->w, hr->h));
+		}
+		else if(h->type == HitboxType::CIRCULAR){
+			CircularHitbox *cr = static_cast<CircularHitbox*>(h);
+			hitboxes.push_back(new CircularHitbox(cr->x, cr->y, cr->r));
+		}
+	}
+
+}
 
 void GameObject2D::draw(void* args) const{
 	draw_f(args);
@@ -208,21 +481,7 @@ GameObject2D::GameObject2D(const GameObject2D& other){
 	h = other.h;
 	draw_f = other.draw_f;
 
-	for(Hitbox* h : hitboxes) delete h;
-	std::vector<Hitbox*> empty;
-	hitboxes = empty;
-
-	for(Hitbox* h : other.hitboxes){
-		if (h->type == HitboxType::RECTANGULAR){
-			RectangularHitbox* hr = dynamic_cast<RectangularHitbox*>(h);
-			add_hitbox(hr->x, hr->y, hr->w, hr->h, HitboxType::RECTANGULAR);
-		}
-		else if(h->type == HitboxType::CIRCULAR){
-			CircularHitbox *cr = dynamic_cast<CircularHitbox*>(h);
-			add_hitbox(cr->x, cr->y, cr->r, 0, HitboxType::CIRCULAR);
-
-		}
-	}
+	copy_hitboxes(other);
 
 }
 
@@ -233,21 +492,7 @@ GameObject2D::GameObject2D(const GameObject2D&& other){
 	h = other.h;
 	draw_f = other.draw_f;
 
-	for(Hitbox* h : hitboxes) delete h;
-	std::vector<Hitbox*> empty;
-	hitboxes = empty;
-
-	for(Hitbox* h : other.hitboxes){
-		if (h->type == HitboxType::RECTANGULAR){
-			RectangularHitbox* hr = dynamic_cast<RectangularHitbox*>(h);
-			add_hitbox(hr->x, hr->y, hr->w, hr->h, HitboxType::RECTANGULAR);
-		}
-		else if(h->type == HitboxType::CIRCULAR){
-			CircularHitbox *cr = dynamic_cast<CircularHitbox*>(h);
-			add_hitbox(cr->x, cr->y, cr->r, 0, HitboxType::CIRCULAR);
-
-		}
-	}
+	copy_hitboxes(other);
 
 }
 
@@ -259,21 +504,8 @@ GameObject2D& GameObject2D::operator=(GameObject2D&& other){
 	h = other.h;
 	draw_f = other.draw_f;
 
-	for(Hitbox* h : hitboxes) delete h;
-	std::vector<Hitbox*> empty;
-	hitboxes = empty;
-
-	for(Hitbox* h : other.hitboxes){
-		if (h->type == HitboxType::RECTANGULAR){
-			RectangularHitbox* hr = dynamic_cast<RectangularHitbox*>(h);
-			add_hitbox(hr->x, hr->y, hr->w, hr->h, HitboxType::RECTANGULAR);
-		}
-		else if(h->type == HitboxType::CIRCULAR){
-			CircularHitbox *cr = dynamic_cast<CircularHitbox*>(h);
-			add_hitbox(cr->x, cr->y, cr->r, 0, HitboxType::CIRCULAR);
-
-		}
-	}
+	copy_hitboxes(other);
+	if (world != nullptr) world->update(this);
 	return (*this);
 
 }
@@ -286,21 +518,8 @@ GameObject2D& GameObject2D::operator=(GameObject2D& other){
 	h = other.h;
 	draw_f = other.draw_f;
 
-	for(Hitbox* h : hitboxes) delete h;
-	std::vector<Hitbox*> empty;
-	hitboxes = empty;
-
-	for(Hitbox* h : other.hitboxes){
-		if (h->type == HitboxType::RECTANGULAR){
-			RectangularHitbox* hr = dynamic_cast<RectangularHitbox*>(h);
-			add_hitbox(hr->x, hr->y, hr->w, hr->h, HitboxType::RECTANGULAR);
-		}
-		else if(h->type == HitboxType::CIRCULAR){
-			CircularHitbox *cr = dynamic_cast<CircularHitbox*>(h);
-			add_hitbox(cr->x, cr->y, cr->r, 0, HitboxType::CIRCULAR);
-
-		}
-	}
+	copy_hitboxes(other);
+	if (world != nullptr) world->update(this);
 	return (*this);
 
 }
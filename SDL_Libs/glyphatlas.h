@@ -0,0 +1,398 @@
+#ifndef __GLYPHATLAS__
+#define __GLYPHATLAS__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cinttypes>
+#include "window.h"
+#include "spritebatch.h"
+#include "fontcache.h"
+#include "textlayout.h"
+
+const int STANDARD_GLYPH_PAGE_SIZE = 512;
+const SDL_Color GLYPH_WHITE = {0xff, 0xff, 0xff, 0xff};
+
+/*
+*
+*	Every glyph of a font is rendered once, the first time it is needed, into a few shared pages.
+*	A text is then drawn as one quad per glyph, so changing the text renders nothing and allocates no texture.
+*	The glyphs are rendered white and get their color from the quads.
+*
+*	Example usage:
+*		GlyphAtlas* atlas = GlyphAtlas::acquire("PATH.ttf", 28, &window);
+*		atlas->draw("Score: 100", 10, 10, color);
+*		GlyphAtlas::release(atlas);
+*
+*	Usually used through Font::set_glyph_mode.
+*
+*/
+
+struct Glyph{
+	unsigned int page;
+	SDL_Rect rect;//on the page, w or h is 0 for glyphs without pixels
+	int advance;
+};
+
+//shelf packed ARGB8888 pages that glyph images get copied into
+class GlyphPages{
+
+protected:
+
+	SDL_Renderer* renderer = nullptr;
+	int page_size = STANDARD_GLYPH_PAGE_SIZE;
+
+	std::vector<SDL_Texture*> pages;
+	int cursor_x = 0, cursor_y = 0, shelf_height = 0;//packing position on the last page
+
+	bool new_page();
+
+public:
+
+	GlyphPages(SDL_Renderer* r, int page_size=STANDARD_GLYPH_PAGE_SIZE);
+	virtual ~GlyphPages();
+
+	//copies the image onto a page, images bigger than a page are cut
+	bool pack(SDL_Surface* s, unsigned int& page, SDL_Rect& rect);
+
+	SDL_Texture* get(unsigned int) const;
+	unsigned int count() const;
+	size_t bytes() const;
+
+	GlyphPages(const GlyphPages&) = delete;
+	GlyphPages& operator=(const GlyphPages&) = delete;
+
+};
+
+class GlyphAtlas{
+
+protected:
+
+	Window* window = nullptr;
+	TTF_Font* font = nullptr;
+	std::string path;
+	int size = 0;
+
+	GlyphPages pages;
+	std::unordered_map<uint32_t, Glyph> glyphs;
+	SpriteBatch batch;
+
+	unsigned int references = 0;
+	static std::unordered_map<std::string, GlyphAtlas*>& atlases();
+	static std::string atlas_key(const std::string& path, int size, SDL_Renderer* r);
+
+	//renders the glyph into a page
+	Glyph& rasterize(uint32_t codepoint);
+
+public:
+
+	GlyphAtlas(const std::string& path, int size, Window* window_ptr);
+	virtual ~GlyphAtlas();
+
+	//one shared atlas per font path, size and renderer
+	static GlyphAtlas* acquire(const std::string& path, int size, Window* window_ptr);
+	static void release(GlyphAtlas*);
+
+	const Glyph& glyph(uint32_t codepoint);
+	int kerning(uint32_t previous, uint32_t codepoint);
+	SDL_Texture* get_page(unsigned int) const;
+
+	//the size the text would be drawn with at scale 1
+	void measure(const std::string& utf8, int& w, int& h);
+	int line_height() const;
+
+	//adds the quads of the text to the batch, x and y are the top left corner
+	void add(SpriteBatch& b, const std::string& utf8, float x, float y, const SDL_Color& c=GLYPH_WHITE, float scale=1.0f, SDL_BlendMode bm=STANDARD_BLENDMODE);
+	void add(SpriteBatch& b, const Paragraph& p, float x, float y, const SDL_Color& c=GLYPH_WHITE, float scale=1.0f, SDL_BlendMode bm=STANDARD_BLENDMODE);
+	//draws the text with its own batch
+	void draw(const std::string& utf8, int x, int y, const SDL_Color& c=GLYPH_WHITE, float scale=1.0f, SDL_BlendMode bm=STANDARD_BLENDMODE);
+	void draw(const Paragraph& p, int x, int y, const SDL_Color& c=GLYPH_WHITE, float scale=1.0f, SDL_BlendMode bm=STANDARD_BLENDMODE);
+	TTF_Font* get_font() const;
+
+	unsigned int glyph_count() const;
+	unsigned int page_count() const;
+
+	GlyphAtlas(const GlyphAtlas&) = delete;
+	GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+};
+
+//gives back the codepoint starting at i and moves i behind it, broken sequences give U+FFFD
+uint32_t next_codepoint(const std::string& utf8, size_t& i);
+
+//IMPLEMENTATION
+uint32_t next_codepoint(const std::string& utf8, size_t& i){
+
+	unsigned char c = static_cast<unsigned char>(utf8[i++]);
+	if (c < 0x80) return c;
+
+	int extra = 0;
+	uint32_t cp = 0;
+	if ((c & 0xe0) == 0xc0){ extra = 1; cp = c & 0x1f; }
+	else if ((c & 0xf0) == 0xe0){ extra = 2; cp = c & 0x0f; }
+	else if ((c & 0xf8) == 0xf0){ extra = 3; cp = c & 0x07; }
+	else return 0xfffd;
+
+	for (int k = 0; k < extra; k++){
+		if (i >= utf8.size() || (static_cast<unsigned char>(utf8[i]) & 0xc0) != 0x80) return 0xfffd;
+		cp = (cp << 6) | (static_cast<unsigned char>(utf8[i++]) & 0x3f);
+	}
+
+	return cp;
+
+}
+
+GlyphPages::GlyphPages(SDL_Renderer* r, int page_size){
+	this->renderer = r;
+	this->page_size = page_size;
+}
+
+GlyphPages::~GlyphPages(){
+	for (SDL_Texture* page : pages) SDL_DestroyTexture(page);
+}
+
+bool GlyphPages::new_page(){
+
+	SDL_Texture* page = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, page_size, page_size);
+	if (page == nullptr) return false;
+
+	//starting out transparent, glyphs only update their own rect
+	std::vector<uint32_t> clear(static_cast<size_t>(page_size) * page_size, 0);
+	SDL_UpdateTexture(page, nullptr, clear.data(), page_size * sizeof(uint32_t));
+	SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+
+	pages.push_back(page);
+	cursor_x = 0;
+	cursor_y = 0;
+	shelf_height = 0;
+	return true;
+
+}
+
+bool GlyphPages::pack(SDL_Surface* s, unsigned int& page, SDL_Rect& rect){
+
+	const int padding = 1;
+	int w = std::min(s->w, page_size), h = std::min(s->h, page_size);
+
+	//shelf packing like TextureAtlas, an image that does not fit anymore starts a new shelf or page
+	if (pages.empty() || cursor_x + w > page_size){
+		cursor_x = 0;
+		cursor_y += shelf_height + padding;
+		shelf_height = 0;
+	}
+	if (pages.empty() || cursor_y + h > page_size){
+		if (!new_page()) return false;
+	}
+
+	page = static_cast<unsigned int>(pages.size() - 1);
+	rect = SDL_Rect{cursor_x, cursor_y, w, h};
+	SDL_UpdateTexture(pages.back(), &rect, s->pixels, s->pitch);
+
+	cursor_x += w + padding;
+	shelf_height = std::max(shelf_height, h);
+
+	return true;
+
+}
+
+SDL_Texture* GlyphPages::get(unsigned int i) const{
+	if (i >= pages.size()) return nullptr;
+	return pages[i];
+}
+
+unsigned int GlyphPages::count() const{
+	return static_cast<unsigned int>(pages.size());
+}
+
+size_t GlyphPages::bytes() const{
+	return pages.size() * static_cast<size_t>(page_size) * page_size * sizeof(uint32_t);
+}
+
+GlyphAtlas::GlyphAtlas(const std::string& path, int size, Window* window_ptr): pages(window_ptr->renderer), batch(window_ptr){
+
+	this->path = path;
+	this->size = size;
+	this->window = window_ptr;
+
+	font = FontCache::instance().acquire(path, size);
+
+}
+
+GlyphAtlas::~GlyphAtlas(){
+
+	FontCache::instance().release(font);
+
+}
+
+std::unordered_map<std::string, GlyphAtlas*>& GlyphAtlas::atlases(){
+	static std::unordered_map<std::string, GlyphAtlas*> all;
+	return all;
+}
+
+std::string GlyphAtlas::atlas_key(const std::string& path, int size, SDL_Renderer* r){
+	return path + ":" + std::to_string(size) + ":" + std::to_string(reinterpret_cast<uintptr_t>(r));
+}
+
+GlyphAtlas* GlyphAtlas::acquire(const std::string& path, int size, Window* window_ptr){
+
+	if (window_ptr == nullptr) return nullptr;
+
+	GlyphAtlas*& atlas = atlases()[atlas_key(path, size, window_ptr->renderer)];
+	if (atlas == nullptr) atlas = new GlyphAtlas(path, size, window_ptr);
+
+	atlas->references += 1;
+	return atlas;
+
+}
+
+void GlyphAtlas::release(GlyphAtlas* atlas){
+
+	if (atlas == nullptr) return;
+	if (atlas->references > 1){
+		atlas->references -= 1;
+		return;
+	}
+
+	atlases().erase(atlas_key(atlas->path, atlas->size, atlas->window->renderer));
+	delete atlas;
+
+}
+
+Glyph& GlyphAtlas::rasterize(uint32_t codepoint){
+
+	Glyph& g = glyphs[codepoint];
+	g.page = 0;
+	g.rect = SDL_Rect{0, 0, 0, 0};
+	g.advance = 0;
+
+	//SDL_ttf renders glyphs by UCS-2 codepoint
+	if (font == nullptr || codepoint > 0xffff) return g;
+	Uint16 ch = static_cast<Uint16>(codepoint);
+
+	int minx, maxx, miny, maxy;
+	if (TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &g.advance) != 0) return g;
+
+	SDL_Surface* rendered = TTF_RenderGlyph_Blended(font, ch, GLYPH_WHITE);
+	if (rendered == nullptr) return g;
+	SDL_Surface* s = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_FreeSurface(rendered);
+	if (s == nullptr) return g;
+
+	if (!pages.pack(s, g.page, g.rect)) g.rect = SDL_Rect{0, 0, 0, 0};
+	SDL_FreeSurface(s);
+
+	return g;
+
+}
+
+const Glyph& GlyphAtlas::glyph(uint32_t codepoint){
+
+	auto it = glyphs.find(codepoint);
+	if (it != glyphs.end()) return it->second;
+	return rasterize(codepoint);
+
+}
+
+int GlyphAtlas::kerning(uint32_t previous, uint32_t codepoint){
+	if (font == nullptr || previous > 0xffff || codepoint > 0xffff) return 0;
+	return TTF_GetFontKerningSizeGlyphs(font, static_cast<Uint16>(previous), static_cast<Uint16>(codepoint));
+}
+
+SDL_Texture* GlyphAtlas::get_page(unsigned int i) const{
+	return pages.get(i);
+}
+
+void GlyphAtlas::measure(const std::string& utf8, int& w, int& h){
+
+	w = 0;
+	h = line_height();
+
+	int pen = 0;
+	uint32_t previous = 0;
+	size_t i = 0;
+	while (i < utf8.size()){
+		uint32_t cp = next_codepoint(utf8, i);
+		if (previous != 0) pen += kerning(previous, cp);
+		const Glyph& g = glyph(cp);
+		w = std::max(w, pen + g.rect.w);
+		pen += g.advance;
+		previous = cp;
+	}
+	w = std::max(w, pen);
+
+}
+
+int GlyphAtlas::line_height() const{
+	if (font == nullptr) return 0;
+	return TTF_FontHeight(font);
+}
+
+void GlyphAtlas::add(SpriteBatch& b, const std::string& utf8, float x, float y, const SDL_Color& c, float scale, SDL_BlendMode bm){
+
+	float pen = x;
+	uint32_t previous = 0;
+	size_t i = 0;
+
+	while (i < utf8.size()){
+
+		uint32_t cp = next_codepoint(utf8, i);
+		if (previous != 0) pen += kerning(previous, cp) * scale;
+
+		const Glyph& g = glyph(cp);
+		if (g.rect.w > 0 && g.rect.h > 0){
+			SDL_FRect dst = {pen, y, g.rect.w * scale, g.rect.h * scale};
+			b.add(pages.get(g.page), &g.rect, dst, 0.0, nullptr, SDL_FLIP_NONE, c, bm);
+		}
+
+		pen += g.advance * scale;
+		previous = cp;
+
+	}
+
+}
+
+void GlyphAtlas::draw(const std::string& utf8, int x, int y, const SDL_Color& c, float scale, SDL_BlendMode bm){
+	batch.begin();
+	add(batch, utf8, static_cast<float>(x), static_cast<float>(y), c, scale, bm);
+	batch.end();
+}
+
+void GlyphAtlas::add(SpriteBatch& b, const Paragraph& p, float x, float y, const SDL_Color& c, float scale, SDL_BlendMode bm){
+	for (const LayoutLine& line : p.lines){
+		add(b, line.text, x + line.x * scale, y + line.y * scale, c, scale, bm);
+	}
+}
+
+void GlyphAtlas::draw(const Paragraph& p, int x, int y, const SDL_Color& c, float scale, SDL_BlendMode bm){
+	batch.begin();
+	add(batch, p, static_cast<float>(x), static_cast<float>(y), c, scale, bm);
+	batch.end();
+}
+
+TTF_Font* GlyphAtlas::get_font() const{
+	return font;
+}
+
+unsigned int GlyphAtlas::glyph_count() const{
+	return static_cast<unsigned int>(glyphs.size());
+}
+
+unsigned int GlyphAtlas::page_count() const{
+	return pages.count();
+}
+
+#endif
@@ -3,13 +3,29 @@
 #define __HITBOX__
 
 #include <cmath>
+#include <vector>
+#include <cstdlib>
 #include <iostream>
+#include <algorithm>
 
 class Hitbox;
 class RectangularHitbox;
 class CircularHitbox;
+struct HitboxShape;
 
 static bool circle_hits_rect(CircularHitbox*, RectangularHitbox*);
+static bool circle_hits_rect(const HitboxShape&, const HitboxShape&);
+
+//the area a hitbox can hit, right and bottom are exclusive
+struct HitboxBounds{
+	int left, top, right, bottom;
+};
+
+//first contact of a moving hitbox, time is the part of the move done before it and the normal points away from the hit hitbox
+struct SweepHit{
+	double time;
+	double nx, ny;
+};
 
 enum HitboxType{
 					NO_HITBOX,
@@ -17,17 +33,85 @@ enum HitboxType{
 					CIRCULAR
 				};
 
+const size_t INLINE_HITBOXES = 4;//hitboxes a HitboxList holds without allocating
 
-//superclass
-class Hitbox{
+struct RectShape{
+	int x, y, w, h;
+};
+
+struct CircleShape{
+	int x, y, r;
+};
+
+//a hitbox as a plain value, type tells which member of the union is used
+struct HitboxShape{
+
+	HitboxType type;
+	union{
+		RectShape rect;
+		CircleShape circle;
+	};
+
+	static HitboxShape rectangle(int x, int y, int w, int h);
+	static HitboxShape circular(int x, int y, int r);
+
+	bool hits(const HitboxShape& other) const;
+	//moves by dx, dy while other stands still, false if they do not touch on the way
+	//a hitbox that already hits other gives time 0 and no normal
+	bool sweep(const HitboxShape& other, double dx, double dy, SweepHit& out) const;
+	HitboxBounds bounds() const;
+	//the same changes GameObject2D::update_hitboxes makes, for circles wdelta is the radius change times two
+	void update(int xdelta, int ydelta, int wdelta=0, int hdelta=0);
+
+};
+
+typedef bool(*hitbox_test_t)(const HitboxShape&, const HitboxShape&);
+typedef bool(*hitbox_sweep_t)(const HitboxShape&, const HitboxShape&, double, double, SweepHit&);
+
+/*
+*
+*	The hitboxes of one object stored by value, the first INLINE_HITBOXES inside the list itself.
+*	Indices stay in the order the hitboxes were added, erase moves the ones behind up.
+*
+*/
+
+class HitboxList{
+
+protected:
+
+	HitboxShape local[INLINE_HITBOXES];
+	std::vector<HitboxShape> more;//the ones after INLINE_HITBOXES
+	size_t count = 0;
 
 public:
 
-	HitboxType type = HitboxType::NO_HITBOX;//for virtual class
+	size_t size() const;
+	bool empty() const;
+	HitboxShape& operator[](size_t);
+	const HitboxShape& operator[](size_t) const;
+
+	void push_back(const HitboxShape&);
+	void erase(size_t);
+	void clear();
 
-	virtual bool hits(Hitbox* other)=0;
+};
+
+//superclass of the hitboxes made with new, for the Hitbox* functions of GameObject2D
+//the tests run on the HitboxShape of both hitboxes, the virtual destructor only lets them be deleted through Hitbox*
+class Hitbox{
+
+public:
+
+	HitboxType type = HitboxType::NO_HITBOX;
 	virtual ~Hitbox(){}
 
+	bool hits(Hitbox* other);
+	//moves by dx, dy while other stands still, false if they do not touch on the way
+	//a hitbox that already hits other gives time 0 and no normal
+	bool sweep(Hitbox* other, double dx, double dy, SweepHit& out);
+	//a copy as a value
+	HitboxShape shape() const;
+
 };
 
 class RectangularHitbox : public Hitbox{
@@ -37,7 +121,6 @@ public:
 	int x=0, y=0, w=0, h=0;
 
 	RectangularHitbox(int x, int y, int w, int h);
-	bool hits(Hitbox* other);
 
 };
 
@@ -48,85 +131,366 @@ public:
 	int x=0, y=0, r=0;
 
 	CircularHitbox(int x, int y, int r);
-	bool hits(Hitbox* other);
 
 };
 
+//IMPLEMENTATION
 CircularHitbox::CircularHitbox(int x_, int y_, int r_): x(x_), y(y_), r(r_){
 	type = HitboxType::CIRCULAR;
 }
-bool CircularHitbox::hits(Hitbox* o){
-	
 
-	switch(o->type){
+RectangularHitbox::RectangularHitbox(int x_, int y_, int w_, int h_): x(x_), y(y_), w(w_), h(h_){
+	type = HitboxType::RECTANGULAR;
+}
 
-		case HitboxType::CIRCULAR: 	{
-									
-										CircularHitbox* ch = dynamic_cast<CircularHitbox*>(o);
-										int xdist = (x-ch->x)*(x-ch->x), ydist = (y-ch->y)*(y-ch->y);
-										double distance = sqrt(xdist+ydist);
-										if (distance < (r+ch->r)) return true;
-										else return false;
-										break;
-									}
+HitboxShape Hitbox::shape() const{
+
+	switch(type){
 		case HitboxType::RECTANGULAR:	{
-											RectangularHitbox* other = dynamic_cast<RectangularHitbox*>(o);
-											return circle_hits_rect(this, other);
+										const RectangularHitbox* rh = static_cast<const RectangularHitbox*>(this);
+										return HitboxShape::rectangle(rh->x, rh->y, rh->w, rh->h);
 										}
-										
-
+		case HitboxType::CIRCULAR:		{
+										const CircularHitbox* ch = static_cast<const CircularHitbox*>(this);
+										return HitboxShape::circular(ch->x, ch->y, ch->r);
+										}
+		default: break;
 	}
 
-	return false;
+	HitboxShape none;
+	none.type = HitboxType::NO_HITBOX;
+	none.rect = RectShape{0, 0, 0, 0};
+	return none;
+
 }
 
-RectangularHitbox::RectangularHitbox(int x_, int y_, int w_, int h_): x(x_), y(y_), w(w_), h(h_){
-	type = HitboxType::RECTANGULAR;
+bool Hitbox::hits(Hitbox* o){
+	return shape().hits(o->shape());
+}
+
+bool Hitbox::sweep(Hitbox* o, double dx, double dy, SweepHit& out){
+	return shape().sweep(o->shape(), dx, dy, out);
+}
+
+HitboxShape HitboxShape::rectangle(int x, int y, int w, int h){
+	HitboxShape s;
+	s.type = HitboxType::RECTANGULAR;
+	s.rect = RectShape{x, y, w, h};
+	return s;
 }
-bool RectangularHitbox::hits(Hitbox* o){
 
-	switch(o->type){
+HitboxShape HitboxShape::circular(int x, int y, int r){
+	HitboxShape s;
+	s.type = HitboxType::CIRCULAR;
+	s.circle = CircleShape{x, y, r};
+	return s;
+}
 
-		case HitboxType::RECTANGULAR: 	{
-										RectangularHitbox* other = dynamic_cast<RectangularHitbox*>(o);
+void HitboxShape::update(int xdelta, int ydelta, int wdelta, int hdelta){
 
-										int leftA=x, rightA=x+w, topA=y, bottomA=y+h, leftB=other->x, rightB=other->x+other->w, topB=other->y, bottomB=other->y+other->h; 
-										if (rightA <= leftB || leftA >= rightB || topA >= bottomB || bottomA <= topB) return false;
-										return true;
+	switch(type){
+		case HitboxType::RECTANGULAR:	rect.x += xdelta;
+										rect.y += ydelta;
+										rect.w += wdelta;
+										rect.h += hdelta;
 										break;
-									 	}		 
-		case HitboxType::CIRCULAR:    	{
-										CircularHitbox* other = dynamic_cast<CircularHitbox*>(o);
-										return circle_hits_rect(other, this);
+		case HitboxType::CIRCULAR:		circle.x += xdelta;
+										circle.y += ydelta;
+										circle.r += (wdelta >> 1);
 										break;
-										}
+		default: break;
+	}
 
+}
 
-	}
+size_t HitboxList::size() const{
+	return count;
+}
+
+bool HitboxList::empty() const{
+	return count == 0;
+}
+
+HitboxShape& HitboxList::operator[](size_t i){
+	return (i < INLINE_HITBOXES) ? local[i] : more[i - INLINE_HITBOXES];
+}
+
+const HitboxShape& HitboxList::operator[](size_t i) const{
+	return (i < INLINE_HITBOXES) ? local[i] : more[i - INLINE_HITBOXES];
+}
+
+void HitboxList::push_back(const HitboxShape& s){
+	if (count < INLINE_HITBOXES) local[count] = s;
+	else more.push_back(s);
+	count += 1;
+}
+
+void HitboxList::erase(size_t i){
 
+	if (i >= count) return;
+	for (size_t j = i; j + 1 < count; j++) (*this)[j] = (*this)[j + 1];
+	count -= 1;
+	if (count >= INLINE_HITBOXES) more.pop_back();
+
+}
+
+void HitboxList::clear(){
+	more.clear();
+	count = 0;
+}
+
+static bool test_none(const HitboxShape&, const HitboxShape&){
 	return false;
+}
+
+static bool test_rect_rect(const HitboxShape& a, const HitboxShape& b){
+
+	const RectShape& ra = a.rect;
+	const RectShape& other = b.rect;
+
+	int leftA=ra.x, rightA=ra.x+ra.w, topA=ra.y, bottomA=ra.y+ra.h, leftB=other.x, rightB=other.x+other.w, topB=other.y, bottomB=other.y+other.h; 
+	if (rightA <= leftB || leftA >= rightB || topA >= bottomB || bottomA <= topB) return false;
+	return true;
 
 }
 
-static bool circle_hits_rect(CircularHitbox* ch, RectangularHitbox* rh){
+static bool test_circle_circle(const HitboxShape& a, const HitboxShape& b){
+
+	const CircleShape& ca = a.circle;
+	const CircleShape& ch = b.circle;
+
+	int xdist = (ca.x-ch.x)*(ca.x-ch.x), ydist = (ca.y-ch.y)*(ca.y-ch.y);
+	double distance = sqrt(xdist+ydist);
+	return distance < (ca.r+ch.r);
+
+}
+
+static bool test_circle_rect(const HitboxShape& a, const HitboxShape& b){
+	return circle_hits_rect(a, b);
+}
+
+static bool test_rect_circle(const HitboxShape& a, const HitboxShape& b){
+	return circle_hits_rect(b, a);
+}
+
+//indexed by the types of both hitboxes
+static const hitbox_test_t HITBOX_TESTS[3][3] = {
+													{test_none, test_none, test_none},
+													{test_none, test_rect_rect, test_rect_circle},
+													{test_none, test_circle_rect, test_circle_circle}
+												};
+
+bool HitboxShape::hits(const HitboxShape& o) const{
+	return HITBOX_TESTS[type][o.type](*this, o);
+}
+
+//two hitboxes can only hit if their bounds overlap
+static HitboxBounds hitbox_bounds(const Hitbox*);
+static bool bounds_overlap(const HitboxBounds&, const HitboxBounds&);
+
+//the circle of the first shape against the rectangle of the second
+static bool circle_hits_rect(const HitboxShape& c, const HitboxShape& r){
+
+	const CircleShape& ch = c.circle;
+	const RectShape& rh = r.rect;
 
 	int cx, cy;//closest x and y
 
-	if (ch->x < rh->x) cx = rh->x;
-	else if (ch->x > rh->x+rh->w) cx = rh->x+rh->w;
-	else cx = ch->x;
+	if (ch.x < rh.x) cx = rh.x;
+	else if (ch.x > rh.x+rh.w) cx = rh.x+rh.w;
+	else cx = ch.x;
 
-	if(ch->y < rh->y) cy = rh->y;
-	else if(ch->y > rh->y+rh->h) cy = rh->y+rh->h;
-	else cy = ch->y;
+	if(ch.y < rh.y) cy = rh.y;
+	else if(ch.y > rh.y+rh.h) cy = rh.y+rh.h;
+	else cy = ch.y;
 
-	int cdx = ch->x-cx;
-	int cdy = ch->y-cy;
+	int cdx = ch.x-cx;
+	int cdy = ch.y-cy;
 
-	if ((cdx*cdx + cdy*cdy) < ch->r*ch->r) return true;
+	if ((cdx*cdx + cdy*cdy) < ch.r*ch.r) return true;
 	else return false;
 
 
 }
 
-#endif
\ No newline at end of file
+static bool circle_hits_rect(CircularHitbox* ch, RectangularHitbox* rh){
+	return circle_hits_rect(ch->shape(), rh->shape());
+}
+
+HitboxBounds HitboxShape::bounds() const{
+
+	switch(type){
+
+		case HitboxType::RECTANGULAR:	return HitboxBounds{std::min(rect.x, rect.x+rect.w), std::min(rect.y, rect.y+rect.h), std::max(rect.x, rect.x+rect.w), std::max(rect.y, rect.y+rect.h)};
+		case HitboxType::CIRCULAR:		{
+										int r = std::abs(circle.r);
+										return HitboxBounds{circle.x-r, circle.y-r, circle.x+r, circle.y+r};
+										}
+		default: break;
+
+	}
+
+	return HitboxBounds{0, 0, 0, 0};
+
+}
+
+static HitboxBounds hitbox_bounds(const Hitbox* hb){
+	return hb->shape().bounds();
+}
+
+static bool bounds_overlap(const HitboxBounds& a, const HitboxBounds& b){
+	//the same comparison RectangularHitbox::hits does
+	return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+//SWEPT TESTS
+//the time the moving hitbox first touches the other one, touching without moving into each other does not count
+//just like hits, so an object stopped at that time can slide along the other one afterwards
+
+//entry and exit time of a moving interval into a fixed one, false if they never overlap
+static bool sweep_axis(double lo, double hi, double other_lo, double other_hi, double d, double& entry, double& leave){
+
+	if (d == 0){
+		entry = -HUGE_VAL;
+		leave = HUGE_VAL;
+		return lo < other_hi && other_lo < hi;
+	}
+
+	double t0 = (other_lo - hi) / d, t1 = (other_hi - lo) / d;
+	entry = std::min(t0, t1);
+	leave = std::max(t0, t1);
+	return true;
+
+}
+
+//point moving from x, y against the closed box, gives the entry time and the axis (0 for x, 1 for y)
+static bool sweep_box(double x, double y, double dx, double dy, double left, double top, double right, double bottom, double& time, int& axis){
+
+	double ex, xx, ey, xy;
+	if (!sweep_axis(x, x, left, right, dx, ex, xx) || !sweep_axis(y, y, top, bottom, dy, ey, xy)) return false;
+
+	double entry = std::max(ex, ey), leave = std::min(xx, xy);
+	if (entry > leave || leave <= 0 || entry > 1) return false;
+
+	time = std::max(entry, 0.0);
+	axis = (ex >= ey) ? 0 : 1;
+	return true;
+
+}
+
+static bool sweep_none(const HitboxShape&, const HitboxShape&, double, double, SweepHit&){
+	return false;
+}
+
+static bool sweep_rect_rect(const HitboxShape& a, const HitboxShape& b, double dx, double dy, SweepHit& out){
+
+	HitboxBounds ba = a.bounds(), bb = b.bounds();
+
+	if (bounds_overlap(ba, bb)){
+		out = SweepHit{0, 0, 0};
+		return true;
+	}
+
+	double ex, xx, ey, xy;
+	if (!sweep_axis(ba.left, ba.right, bb.left, bb.right, dx, ex, xx) || !sweep_axis(ba.top, ba.bottom, bb.top, bb.bottom, dy, ey, xy)) return false;
+
+	double entry = std::max(ex, ey), leave = std::min(xx, xy);
+	if (entry >= leave || leave <= 0 || entry < 0 || entry > 1) return false;
+
+	if (ex >= ey) out = SweepHit{entry, (dx > 0) ? -1.0 : 1.0, 0};
+	else out = SweepHit{entry, 0, (dy > 0) ? -1.0 : 1.0};
+	return true;
+
+}
+
+//circle moving against the rectangle grown by its radius, with rounded corners
+static bool sweep_circle_rect(const HitboxShape& a, const HitboxShape& b, double dx, double dy, SweepHit& out){
+
+	const CircleShape& ch = a.circle;
+
+	if (ch.r == 0) return false;
+	if (circle_hits_rect(a, b)){
+		out = SweepHit{0, 0, 0};
+		return true;
+	}
+
+	HitboxBounds rb = b.bounds();
+	double r = std::abs(ch.r), x = ch.x, y = ch.y;
+
+	double time;
+	int axis;
+	if (!sweep_box(x, y, dx, dy, rb.left - r, rb.top - r, rb.right + r, rb.bottom + r, time, axis)) return false;
+
+	double px = x + dx * time, py = y + dy * time;
+	bool in_x = px >= rb.left && px <= rb.right, in_y = py >= rb.top && py <= rb.bottom;
+
+	if (in_x || in_y){
+		if (axis == 0) out = SweepHit{time, (dx > 0) ? -1.0 : 1.0, 0};
+		else out = SweepHit{time, 0, (dy > 0) ? -1.0 : 1.0};
+		return true;
+	}
+
+	//entered next to a corner, the circle has to reach the corner itself
+	double cx = (px < rb.left) ? rb.left : rb.right, cy = (py < rb.top) ? rb.top : rb.bottom;
+	double ox = x - cx, oy = y - cy;
+
+	double qa = dx * dx + dy * dy, qb = ox * dx + oy * dy, qc = ox * ox + oy * oy - r * r;
+	double disc = qb * qb - qa * qc;
+	if (qa == 0 || qb >= 0 || disc <= 0) return false;
+
+	double t = (-qb - sqrt(disc)) / qa;
+	if (t > 1) return false;
+	t = std::max(t, 0.0);
+
+	out = SweepHit{t, (ox + dx * t) / r, (oy + dy * t) / r};
+	return true;
+
+}
+
+static bool sweep_rect_circle(const HitboxShape& a, const HitboxShape& b, double dx, double dy, SweepHit& out){
+
+	//the circle moving the other way, seen from the rectangle
+	if (!sweep_circle_rect(b, a, -dx, -dy, out)) return false;
+	out.nx = -out.nx;
+	out.ny = -out.ny;
+	return true;
+
+}
+
+static bool sweep_circle_circle(const HitboxShape& a, const HitboxShape& b, double dx, double dy, SweepHit& out){
+
+	const CircleShape& ca = a.circle;
+	const CircleShape& ch = b.circle;
+
+	if (test_circle_circle(a, b)){
+		out = SweepHit{0, 0, 0};
+		return true;
+	}
+
+	double r = ca.r + ch.r, ox = ca.x - ch.x, oy = ca.y - ch.y;
+	if (r <= 0) return false;
+
+	double qa = dx * dx + dy * dy, qb = ox * dx + oy * dy, qc = ox * ox + oy * oy - r * r;
+	double disc = qb * qb - qa * qc;
+	if (qa == 0 || qb >= 0 || disc <= 0) return false;
+
+	double t = (-qb - sqrt(disc)) / qa;
+	if (t < 0 || t > 1) return false;
+
+	out = SweepHit{t, (ox + dx * t) / r, (oy + dy * t) / r};
+	return true;
+
+}
+
+//indexed like HITBOX_TESTS, the first hitbox is the moving one
+static const hitbox_sweep_t HITBOX_SWEEPS[3][3] = {
+														{sweep_none, sweep_none, sweep_none},
+														{sweep_none, sweep_rect_rect, sweep_rect_circle},
+														{sweep_none, sweep_circle_rect, sweep_circle_circle}
+													};
+
+bool HitboxShape::sweep(const HitboxShape& o, double dx, double dy, SweepHit& out) const{
+	return HITBOX_SWEEPS[type][o.type](*this, o, dx, dy, out);
+}
+
+#endif
@@ -0,0 +1,356 @@
+#ifndef __HITBOX_BATCH__
+#define __HITBOX_BATCH__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <vector>
+#include <algorithm>
+#include <cinttypes>
+#include "hitbox.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HITBOX_X86
+#include <immintrin.h>
+#endif
+
+//lets the compiler emit AVX2 code for single functions, the CPU check happens at runtime
+#if defined(__GNUC__) || defined(__clang__)
+#define HITBOX_SSE2 __attribute__((target("sse2")))
+#define HITBOX_AVX2 __attribute__((target("avx2")))
+#else
+#define HITBOX_SSE2
+#define HITBOX_AVX2
+#endif
+
+/*
+*
+*	Many hitboxes stored as structure of arrays, tested against one hitbox at once.
+*	The coordinates stay ints and the tests do the same integer math as Hitbox::hits, with squared distances
+*	instead of sqrt, so the result is the same as calling hits on every hitbox.
+*	Circles get compared as squared ints, which is exact as long as distances stay below 32768 pixels.
+*	The scalar, SSE2 or AVX2 version is picked at runtime like in pixelops.h.
+*
+*	Example usage:
+*		HitboxBatch swarm;
+*		for (Enemy& e : enemies) swarm.add(e.hitbox);
+*		//in the game loop, after moving the enemies
+*		for (size_t i = 0; i < enemies.size(); i++) swarm.set(i, enemies[i].hitbox);
+*		swarm.hits(bullet, mask);//bit i of mask is set if bullet hits hitbox i
+*
+*/
+
+enum HitboxBatchLevel{
+					HITBOX_SCALAR,
+					HITBOX_SSE2_LEVEL,
+					HITBOX_AVX2_LEVEL
+				};
+
+HitboxBatchLevel hitbox_batch_level();
+//for comparing the kernels, a level the CPU does not support falls back to the best supported one
+void hitbox_batch_force_level(HitboxBatchLevel);
+
+class HitboxBatch{
+
+protected:
+
+	//rectangles use all four, circles keep their radius in w
+	std::vector<int32_t> xs, ys, ws, hs;
+	std::vector<int32_t> types;
+
+public:
+
+	HitboxBatch();
+	virtual ~HitboxBatch();
+
+	//gives back the index of the hitbox in the batch
+	size_t add(const HitboxShape&);
+	size_t add(const Hitbox&);
+	//overwrites hitbox i, for example after the object moved
+	void set(size_t i, const HitboxShape&);
+	void set(size_t i, const Hitbox&);
+	void clear();
+	void reserve(size_t);
+	size_t size() const;
+
+	//bit i%32 of mask[i/32] tells if shape hits hitbox i, gives back how many are hit
+	size_t hits(const HitboxShape& shape, std::vector<uint32_t>& mask) const;
+	size_t hits(const Hitbox& shape, std::vector<uint32_t>& mask) const;
+
+};
+
+//IMPLEMENTATION
+static HitboxBatchLevel detected_hitbox_batch_level(){
+#ifdef HITBOX_X86
+	if (SDL_HasAVX2()) return HITBOX_AVX2_LEVEL;
+	if (SDL_HasSSE2()) return HITBOX_SSE2_LEVEL;
+#endif
+	return HITBOX_SCALAR;
+}
+
+static HitboxBatchLevel current_hitbox_batch_level = detected_hitbox_batch_level();
+
+HitboxBatchLevel hitbox_batch_level(){
+	return current_hitbox_batch_level;
+}
+
+void hitbox_batch_force_level(HitboxBatchLevel level){
+	current_hitbox_batch_level = std::min(level, detected_hitbox_batch_level());
+}
+
+//the query shape, unpacked once
+struct BatchShape{
+	int32_t type, x, y, w, h;//w is the radius for circles
+};
+
+//SCALAR KERNEL
+//the tests of hitbox.h on rebuilt shapes, also used for the lanes left over by the SIMD kernels
+static void hitbox_batch_scalar(const BatchShape& s, const int32_t* xs, const int32_t* ys, const int32_t* ws, const int32_t* hs, const int32_t* types, size_t begin, size_t end, uint32_t* mask){
+
+	HitboxShape shape = (s.type == HitboxType::CIRCULAR) ? HitboxShape::circular(s.x, s.y, s.w) : HitboxShape::rectangle(s.x, s.y, s.w, s.h);
+
+	for (size_t i = begin; i < end; i++){
+
+		HitboxShape other = (types[i] == HitboxType::CIRCULAR) ? HitboxShape::circular(xs[i], ys[i], ws[i]) : HitboxShape::rectangle(xs[i], ys[i], ws[i], hs[i]);
+		if (shape.hits(other)) mask[i >> 5] |= 1u << (i & 31);
+
+	}
+
+}
+
+#ifdef HITBOX_X86
+
+//SSE2 KERNEL
+//low 32 bits of the products, SSE2 only multiplies two lanes at once
+HITBOX_SSE2 static inline __m128i hitbox_mullo_sse2(__m128i a, __m128i b){
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+HITBOX_SSE2 static inline __m128i hitbox_select_sse2(__m128i m, __m128i a, __m128i b){
+	return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+}
+
+//circle_hits_rect with the same clamping order, so rectangles with negative size give the same result
+HITBOX_SSE2 static inline __m128i hitbox_circle_rect_sse2(__m128i cx, __m128i cy, __m128i cr, __m128i rx, __m128i ry, __m128i rw, __m128i rh){
+
+	__m128i right = _mm_add_epi32(rx, rw), bottom = _mm_add_epi32(ry, rh);
+
+	__m128i px = hitbox_select_sse2(_mm_cmplt_epi32(cx, rx), rx, hitbox_select_sse2(_mm_cmpgt_epi32(cx, right), right, cx));
+	__m128i py = hitbox_select_sse2(_mm_cmplt_epi32(cy, ry), ry, hitbox_select_sse2(_mm_cmpgt_epi32(cy, bottom), bottom, cy));
+
+	__m128i dx = _mm_sub_epi32(cx, px), dy = _mm_sub_epi32(cy, py);
+	__m128i distance = _mm_add_epi32(hitbox_mullo_sse2(dx, dx), hitbox_mullo_sse2(dy, dy));
+	return _mm_cmplt_epi32(distance, hitbox_mullo_sse2(cr, cr));
+
+}
+
+HITBOX_SSE2 static void hitbox_batch_sse2(const BatchShape& s, const int32_t* xs, const int32_t* ys, const int32_t* ws, const int32_t* hs, const int32_t* types, size_t n, uint32_t* mask){
+
+	__m128i sx = _mm_set1_epi32(s.x), sy = _mm_set1_epi32(s.y), sw = _mm_set1_epi32(s.w), sh = _mm_set1_epi32(s.h);
+	__m128i sright = _mm_add_epi32(sx, sw), sbottom = _mm_add_epi32(sy, sh);
+	__m128i circular = _mm_set1_epi32(HitboxType::CIRCULAR), zero = _mm_setzero_si128();
+
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4){
+
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(xs + i));
+		__m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ys + i));
+		__m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ws + i));
+		__m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hs + i));
+		__m128i is_circle = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(types + i)), circular);
+
+		__m128i hit_rect, hit_circle;
+		if (s.type == HitboxType::RECTANGULAR){
+			__m128i right = _mm_add_epi32(x, w), bottom = _mm_add_epi32(y, h);
+			hit_rect = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(sright, x), _mm_cmpgt_epi32(right, sx)), _mm_and_si128(_mm_cmpgt_epi32(sbottom, y), _mm_cmpgt_epi32(bottom, sy)));
+			hit_circle = hitbox_circle_rect_sse2(x, y, w, sx, sy, sw, sh);
+		}
+		else{
+			hit_rect = hitbox_circle_rect_sse2(sx, sy, sw, x, y, w, h);
+			__m128i dx = _mm_sub_epi32(sx, x), dy = _mm_sub_epi32(sy, y), radii = _mm_add_epi32(sw, w);
+			__m128i distance = _mm_add_epi32(hitbox_mullo_sse2(dx, dx), hitbox_mullo_sse2(dy, dy));
+			hit_circle = _mm_and_si128(_mm_cmpgt_epi32(radii, zero), _mm_cmplt_epi32(distance, hitbox_mullo_sse2(radii, radii)));
+		}
+
+		__m128i hit = hitbox_select_sse2(is_circle, hit_circle, hit_rect);
+		uint32_t bits = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(hit)));
+		mask[i >> 5] |= bits << (i & 31);
+
+	}
+
+	hitbox_batch_scalar(s, xs, ys, ws, hs, types, i, n, mask);
+
+}
+
+//AVX2 KERNEL
+HITBOX_AVX2 static inline __m256i hitbox_lt_avx2(__m256i a, __m256i b){
+	return _mm256_cmpgt_epi32(b, a);
+}
+
+HITBOX_AVX2 static inline __m256i hitbox_circle_rect_avx2(__m256i cx, __m256i cy, __m256i cr, __m256i rx, __m256i ry, __m256i rw, __m256i rh){
+
+	__m256i right = _mm256_add_epi32(rx, rw), bottom = _mm256_add_epi32(ry, rh);
+
+	__m256i px = _mm256_blendv_epi8(_mm256_blendv_epi8(cx, right, _mm256_cmpgt_epi32(cx, right)), rx, hitbox_lt_avx2(cx, rx));
+	__m256i py = _mm256_blendv_epi8(_mm256_blendv_epi8(cy, bottom, _mm256_cmpgt_epi32(cy, bottom)), ry, hitbox_lt_avx2(cy, ry));
+
+	__m256i dx = _mm256_sub_epi32(cx, px), dy = _mm256_sub_epi32(cy, py);
+	__m256i distance = _mm256_add_epi32(_mm256_mullo_epi32(dx, dx), _mm256_mullo_epi32(dy, dy));
+	return hitbox_lt_avx2(distance, _mm256_mullo_epi32(cr, cr));
+
+}
+
+HITBOX_AVX2 static void hitbox_batch_avx2(const BatchShape& s, const int32_t* xs, const int32_t* ys, const int32_t* ws, const int32_t* hs, const int32_t* types, size_t n, uint32_t* mask){
+
+	__m256i sx = _mm256_set1_epi32(s.x), sy = _mm256_set1_epi32(s.y), sw = _mm256_set1_epi32(s.w), sh = _mm256_set1_epi32(s.h);
+	__m256i sright = _mm256_add_epi32(sx, sw), sbottom = _mm256_add_epi32(sy, sh);
+	__m256i circular = _mm256_set1_epi32(HitboxType::CIRCULAR), zero = _mm256_setzero_si256();
+
+	size_t i = 0;
+	for (; i + 8 <= n; i += 8){
+
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i));
+		__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys + i));
+		__m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ws + i));
+		__m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hs + i));
+		__m256i is_circle = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(types + i)), circular);
+
+		__m256i hit_rect, hit_circle;
+		if (s.type == HitboxType::RECTANGULAR){
+			__m256i right = _mm256_add_epi32(x, w), bottom = _mm256_add_epi32(y, h);
+			hit_rect = _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi32(sright, x), _mm256_cmpgt_epi32(right, sx)), _mm256_and_si256(_mm256_cmpgt_epi32(sbottom, y), _mm256_cmpgt_epi32(bottom, sy)));
+			hit_circle = hitbox_circle_rect_avx2(x, y, w, sx, sy, sw, sh);
+		}
+		else{
+			hit_rect = hitbox_circle_rect_avx2(sx, sy, sw, x, y, w, h);
+			__m256i dx = _mm256_sub_epi32(sx, x), dy = _mm256_sub_epi32(sy, y), radii = _mm256_add_epi32(sw, w);
+			__m256i distance = _mm256_add_epi32(_mm256_mullo_epi32(dx, dx), _mm256_mullo_epi32(dy, dy));
+			hit_circle = _mm256_and_si256(_mm256_cmpgt_epi32(radii, zero), hitbox_lt_avx2(distance, _mm256_mullo_epi32(radii, radii)));
+		}
+
+		__m256i hit = _mm256_blendv_epi8(hit_rect, hit_circle, is_circle);
+		uint32_t bits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+		mask[i >> 5] |= bits << (i & 31);
+
+	}
+
+	hitbox_batch_scalar(s, xs, ys, ws, hs, types, i, n, mask);
+
+}
+
+#endif
+
+HitboxBatch::HitboxBatch(){
+}
+
+HitboxBatch::~HitboxBatch(){
+}
+
+size_t HitboxBatch::add(const HitboxShape& hb){
+
+	xs.push_back(0);
+	ys.push_back(0);
+	ws.push_back(0);
+	hs.push_back(0);
+	types.push_back(HitboxType::NO_HITBOX);
+
+	set(xs.size() - 1, hb);
+	return xs.size() - 1;
+
+}
+
+size_t HitboxBatch::add(const Hitbox& hb){
+	return add(hb.shape());
+}
+
+void HitboxBatch::set(size_t i, const HitboxShape& hb){
+
+	if (i >= xs.size()) return;
+
+	types[i] = hb.type;
+	switch(hb.type){
+
+		case HitboxType::RECTANGULAR:	xs[i] = hb.rect.x;
+										ys[i] = hb.rect.y;
+										ws[i] = hb.rect.w;
+										hs[i] = hb.rect.h;
+										break;
+		case HitboxType::CIRCULAR:		xs[i] = hb.circle.x;
+										ys[i] = hb.circle.y;
+										ws[i] = hb.circle.r;
+										hs[i] = 0;
+										break;
+		default: break;
+
+	}
+
+}
+
+void HitboxBatch::set(size_t i, const Hitbox& hb){
+	set(i, hb.shape());
+}
+
+void HitboxBatch::clear(){
+	xs.clear();
+	ys.clear();
+	ws.clear();
+	hs.clear();
+	types.clear();
+}
+
+void HitboxBatch::reserve(size_t n){
+	xs.reserve(n);
+	ys.reserve(n);
+	ws.reserve(n);
+	hs.reserve(n);
+	types.reserve(n);
+}
+
+size_t HitboxBatch::size() const{
+	return xs.size();
+}
+
+size_t HitboxBatch::hits(const Hitbox& hb, std::vector<uint32_t>& mask) const{
+	return hits(hb.shape(), mask);
+}
+
+size_t HitboxBatch::hits(const HitboxShape& hb, std::vector<uint32_t>& mask) const{
+
+	size_t n = xs.size();
+	mask.assign((n + 31) / 32, 0);
+	if (n == 0) return 0;
+
+	BatchShape s = {hb.type, 0, 0, 0, 0};
+	if (hb.type == HitboxType::RECTANGULAR) s = BatchShape{hb.type, hb.rect.x, hb.rect.y, hb.rect.w, hb.rect.h};
+	else if (hb.type == HitboxType::CIRCULAR) s = BatchShape{hb.type, hb.circle.x, hb.circle.y, hb.circle.r, 0};
+	else return 0;
+
+	switch (current_hitbox_batch_level){
+#ifdef HITBOX_X86
+		case HITBOX_AVX2_LEVEL: hitbox_batch_avx2(s, xs.data(), ys.data(), ws.data(), hs.data(), types.data(), n, mask.data()); break;
+		case HITBOX_SSE2_LEVEL: hitbox_batch_sse2(s, xs.data(), ys.data(), ws.data(), hs.data(), types.data(), n, mask.data()); break;
+#endif
+		default: hitbox_batch_scalar(s, xs.data(), ys.data(), ws.data(), hs.data(), types.data(), 0, n, mask.data()); break;
+	}
+
+	size_t count = 0;
+	for (uint32_t word : mask){
+		for (; word != 0; word &= word - 1) count++;
+	}
+	return count;
+
+}
+
+#endif
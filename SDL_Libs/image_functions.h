@@ -3,6 +3,9 @@
 #define __IMAGE_FUNCTIONS__
 
 #include <string>
+#include <fstream>
+#include <algorithm>
+#include <cinttypes>
 
 #ifdef _WIN32
 #include <SDL.h>
@@ -19,6 +22,10 @@
 
 SDL_Surface* load_image(const std::string&, const SDL_Surface*);
 SDL_Texture* load_texture(const std::string&, SDL_Renderer* r);
+//a new surface with half the width and height, every pixel is the average of 2x2 pixels. Only for 32 bit surfaces
+SDL_Surface* halve_surface(SDL_Surface*);
+//reads only the header of a PNG file, gives back false if the file is no PNG
+bool read_png_size(const std::string&, int& w, int& h);
 
 
 
@@ -48,4 +55,57 @@ SDL_Texture* load_texture(const std::string& path, SDL_Renderer* r){
 	return back;
 }
 
-#endif
\ No newline at end of file
+SDL_Surface* halve_surface(SDL_Surface* s){
+
+	if (s == nullptr || s->format->BytesPerPixel != 4) return nullptr;
+
+	int w = std::max(s->w / 2, 1), h = std::max(s->h / 2, 1);
+	SDL_Surface* half = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, s->format->format);
+	if (half == nullptr) return nullptr;
+
+	SDL_LockSurface(s);
+	for (int y = 0; y < h; y++){
+
+		//odd sizes and 1 pixel wide images repeat the last line
+		const uint32_t* row0 = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(s->pixels) + (2 * y) * s->pitch);
+		const uint32_t* row1 = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(s->pixels) + std::min(2 * y + 1, s->h - 1) * s->pitch);
+		uint32_t* out = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(half->pixels) + y * half->pitch);
+
+		for (int x = 0; x < w; x++){
+			int x0 = 2 * x, x1 = std::min(2 * x + 1, s->w - 1);
+			uint32_t px = 0;
+			for (int k = 0; k < 32; k += 8){
+				uint32_t sum = ((row0[x0] >> k) & 0xff) + ((row0[x1] >> k) & 0xff) + ((row1[x0] >> k) & 0xff) + ((row1[x1] >> k) & 0xff);
+				px |= ((sum + 2) >> 2) << k;
+			}
+			out[x] = px;
+		}
+
+	}
+	SDL_UnlockSurface(s);
+
+	return half;
+
+}
+
+bool read_png_size(const std::string& path, int& w, int& h){
+
+	//8 bytes signature, then the IHDR chunk: 4 bytes length, 4 bytes type, width and height big endian
+	const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	unsigned char header[24];
+
+	std::ifstream file(path.c_str(), std::ios::binary);
+	if (!file.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+
+	for (int i = 0; i < 8; i++){
+		if (header[i] != signature[i]) return false;
+	}
+	if (header[12] != 'I' || header[13] != 'H' || header[14] != 'D' || header[15] != 'R') return false;
+
+	w = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+	h = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+	return true;
+
+}
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef __LAYER__
+#define __LAYER__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <functional>
+#include "window.h"
+#include "texture.h"
+
+const SDL_Color LAYER_CLEAR = {0x00, 0x00, 0x00, 0x00};
+
+/*
+*
+*	An offscreen canvas for things that do not change every frame, like a background.
+*	The painter draws into the canvas once, after that drawing the layer is a single copy
+*	until the layer is invalidated.
+*
+*	Example usage:
+*		Layer background(&window, 800, 600, [&]{
+*			for (Texture& t : tiles) t.draw();
+*		});
+*		//in the game loop
+*		if (tiles_changed) background.invalidate();
+*		background.draw(0, 0);
+*
+*	Every layer is invalidated on its own, so HUD, terrain and background can be kept in different layers.
+*
+*/
+
+class Layer{
+
+protected:
+
+	Window* window = nullptr;
+	Texture canvas;
+	std::function<void()> painter;
+
+	SDL_Color clear_color = LAYER_CLEAR;
+	bool valid = false;
+	unsigned int repaints = 0;
+
+public:
+
+	Layer();
+	//the painter is called with the canvas as render target, drawing like on the window
+	Layer(Window* window_ptr, int w, int h, const std::function<void()>& p);
+	virtual ~Layer();
+
+	void create(Window* window_ptr, int w, int h);
+	void set_painter(const std::function<void()>&);
+	void set_clear_color(const SDL_Color&);
+
+	//the next draw or update paints the canvas again
+	void invalidate();
+	bool is_valid() const;
+	//paints the canvas if it was invalidated
+	void update();
+
+	void draw();
+	void draw(int x, int y, int w=-1, int h=-1);
+	//render targets can lose their content, this invalidates the layer when that happens
+	void handle(SDL_Event&);
+
+	//for modulation, blendmode and so on of the composited canvas
+	Texture& get_texture();
+	unsigned int get_repaints() const;
+
+	Layer(const Layer&) = delete;
+	Layer& operator=(const Layer&) = delete;
+
+};
+
+Layer::Layer(){
+}
+
+Layer::Layer(Window* window_ptr, int w, int h, const std::function<void()>& p){
+	create(window_ptr, w, h);
+	set_painter(p);
+}
+
+Layer::~Layer(){
+}
+
+void Layer::create(Window* window_ptr, int w, int h){
+
+	this->window = window_ptr;
+	canvas.set_window(window_ptr);
+	canvas.create_blank(w, h);
+	valid = false;
+
+}
+
+void Layer::set_painter(const std::function<void()>& p){
+	painter = p;
+	valid = false;
+}
+
+void Layer::set_clear_color(const SDL_Color& c){
+	clear_color = c;
+	valid = false;
+}
+
+void Layer::invalidate(){
+	valid = false;
+}
+
+bool Layer::is_valid() const{
+	return valid;
+}
+
+void Layer::update(){
+
+	if (valid || window == nullptr || canvas.get_width() <= 0) return;
+
+	SDL_Renderer* r = window->renderer;
+	SDL_Texture* old_target = SDL_GetRenderTarget(r);
+	uint8_t cr, cg, cb, ca;
+	SDL_GetRenderDrawColor(r, &cr, &cg, &cb, &ca);
+
+	canvas.set_as_render_target(r);
+	SDL_SetRenderDrawColor(r, clear_color.r, clear_color.g, clear_color.b, clear_color.a);
+	SDL_RenderClear(r);
+	if (painter) painter();
+
+	SDL_SetRenderTarget(r, old_target);
+	SDL_SetRenderDrawColor(r, cr, cg, cb, ca);
+
+	valid = true;
+	repaints += 1;
+
+}
+
+void Layer::draw(){
+	update();
+	canvas.draw();
+}
+
+void Layer::draw(int x, int y, int w, int h){
+	update();
+	canvas.draw(x, y, w, h);
+}
+
+void Layer::handle(SDL_Event& e){
+	if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) valid = false;
+}
+
+Texture& Layer::get_texture(){
+	return canvas;
+}
+
+unsigned int Layer::get_repaints() const{
+	return repaints;
+}
+
+#endif
@@ -0,0 +1,482 @@
+#ifndef __PIXELOPS__
+#define __PIXELOPS__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <vector>
+#include <algorithm>
+#include <cinttypes>
+#include "texture.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PIXELOPS_X86
+#include <immintrin.h>
+#endif
+
+//lets the compiler emit AVX2 code for single functions, the CPU check happens at runtime
+#if defined(__GNUC__) || defined(__clang__)
+#define PIXELOPS_SSE2 __attribute__((target("sse2")))
+#define PIXELOPS_AVX2 __attribute__((target("avx2")))
+#else
+#define PIXELOPS_SSE2
+#define PIXELOPS_AVX2
+#endif
+
+/*
+*
+*	Per pixel operations on 32 bit surfaces, as given by Texture::get_pixels.
+*	Every operation has a scalar, an SSE2 and an AVX2 version, the best one the CPU supports is picked at runtime.
+*	All versions give exactly the same result.
+*
+*	Example usage:
+*		Texture t("PATH.png", &window);
+*		tint_pixels(t, 0xff, 0x80, 0x80);//uploads the result again, other textures of PATH.png stay as they are
+*
+*/
+
+enum PixelOpsLevel{
+					PIXELOPS_SCALAR,
+					PIXELOPS_SSE2_LEVEL,
+					PIXELOPS_AVX2_LEVEL
+				};
+
+PixelOpsLevel pixelops_level();
+//for comparing the kernels, a level the CPU does not support falls back to the best supported one
+void pixelops_force_level(PixelOpsLevel);
+
+//multiplies red, green and blue with r/255, g/255 and b/255
+void tint_pixels(SDL_Surface*, uint8_t r, uint8_t g, uint8_t b);
+//multiplies the color channels with alpha/255
+void premultiply_alpha(SDL_Surface*);
+//makes every pixel with the given color fully transparent
+void color_key_pixels(SDL_Surface*, uint8_t r, uint8_t g, uint8_t b);
+//averages every channel over a (2*radius+1)^2 box, the edges are repeated
+void box_blur_pixels(SDL_Surface*, int radius);
+
+//the same for textures, the result is uploaded right away
+//they edit the own copy get_surface gives the texture, never the image shared through the TextureCache
+void tint_pixels(Texture&, uint8_t r, uint8_t g, uint8_t b);
+void premultiply_alpha(Texture&);
+void color_key_pixels(Texture&, uint8_t r, uint8_t g, uint8_t b);
+void box_blur_pixels(Texture&, int radius);
+
+//IMPLEMENTATION
+static PixelOpsLevel detected_pixelops_level(){
+#ifdef PIXELOPS_X86
+	if (SDL_HasAVX2()) return PIXELOPS_AVX2_LEVEL;
+	if (SDL_HasSSE2()) return PIXELOPS_SSE2_LEVEL;
+#endif
+	return PIXELOPS_SCALAR;
+}
+
+static PixelOpsLevel current_pixelops_level = detected_pixelops_level();
+
+PixelOpsLevel pixelops_level(){
+	return current_pixelops_level;
+}
+
+void pixelops_force_level(PixelOpsLevel level){
+	current_pixelops_level = std::min(level, detected_pixelops_level());
+}
+
+static bool is_32bit(const SDL_Surface* s){
+	return s != nullptr && s->format->BytesPerPixel == 4;
+}
+
+//rounded c*f/255, exact for all 8 bit values
+static inline uint32_t mul_div255(uint32_t c, uint32_t f){
+	uint32_t t = c * f + 128;
+	return (t + (t >> 8)) >> 8;
+}
+
+static inline uint32_t mul_pixel(uint32_t px, uint32_t factors){
+	uint32_t out = 0;
+	for (int k = 0; k < 32; k += 8){
+		out |= mul_div255((px >> k) & 0xff, (factors >> k) & 0xff) << k;
+	}
+	return out;
+}
+
+//factors for the alpha channel are 255, so alpha stays as it is
+static inline uint32_t alpha_factors(uint32_t px, const SDL_PixelFormat* f){
+	uint32_t a = (px >> f->Ashift) & 0xff;
+	return ((a * 0x01010101u) & ~f->Amask) | (0xffu << f->Ashift);
+}
+
+//SCALAR KERNELS
+static void tint_row_scalar(uint32_t* row, int n, uint32_t factors){
+	for (int i = 0; i < n; i++) row[i] = mul_pixel(row[i], factors);
+}
+
+static void premultiply_row_scalar(uint32_t* row, int n, const SDL_PixelFormat* f){
+	for (int i = 0; i < n; i++) row[i] = mul_pixel(row[i], alpha_factors(row[i], f));
+}
+
+static void color_key_row_scalar(uint32_t* row, int n, uint32_t key, uint32_t colormask, uint32_t amask){
+	for (int i = 0; i < n; i++){
+		if ((row[i] & colormask) == key) row[i] &= ~amask;
+	}
+}
+
+static inline uint32_t box_average(int sum, float inv){
+	return static_cast<uint32_t>(static_cast<float>(sum) * inv + 0.5f);
+}
+
+//one row or column of the blur, stride is in pixels
+static void blur_line_scalar(const uint32_t* src, int src_stride, uint32_t* dst, int dst_stride, int n, int radius, float inv){
+
+	int sums[4] = {0, 0, 0, 0};
+	for (int k = -radius; k <= radius; k++){
+		uint32_t px = src[std::min(std::max(k, 0), n - 1) * src_stride];
+		for (int c = 0; c < 4; c++) sums[c] += (px >> (c * 8)) & 0xff;
+	}
+
+	for (int i = 0; i < n; i++){
+
+		uint32_t out = 0;
+		for (int c = 0; c < 4; c++) out |= box_average(sums[c], inv) << (c * 8);
+		dst[i * dst_stride] = out;
+
+		uint32_t leaving = src[std::max(i - radius, 0) * src_stride];
+		uint32_t entering = src[std::min(i + radius + 1, n - 1) * src_stride];
+		for (int c = 0; c < 4; c++){
+			sums[c] += static_cast<int>((entering >> (c * 8)) & 0xff) - static_cast<int>((leaving >> (c * 8)) & 0xff);
+		}
+
+	}
+
+}
+
+#ifdef PIXELOPS_X86
+
+//SSE2 KERNELS
+PIXELOPS_SSE2 static inline __m128i mul_div255_sse2(__m128i c16, __m128i f16){
+	__m128i t = _mm_add_epi16(_mm_mullo_epi16(c16, f16), _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+//four pixels times four per pixel factors
+PIXELOPS_SSE2 static inline __m128i mul_pixels_sse2(__m128i px, __m128i factors){
+	const __m128i zero = _mm_setzero_si128();
+	__m128i lo = mul_div255_sse2(_mm_unpacklo_epi8(px, zero), _mm_unpacklo_epi8(factors, zero));
+	__m128i hi = mul_div255_sse2(_mm_unpackhi_epi8(px, zero), _mm_unpackhi_epi8(factors, zero));
+	return _mm_packus_epi16(lo, hi);
+}
+
+PIXELOPS_SSE2 static void tint_row_sse2(uint32_t* row, int n, uint32_t factors){
+	const __m128i f = _mm_set1_epi32(static_cast<int>(factors));
+	int i = 0;
+	for (; i + 4 <= n; i += 4){
+		__m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), mul_pixels_sse2(px, f));
+	}
+	tint_row_scalar(row + i, n - i, factors);
+}
+
+PIXELOPS_SSE2 static void premultiply_row_sse2(uint32_t* row, int n, const SDL_PixelFormat* f){
+	const __m128i shift = _mm_cvtsi32_si128(f->Ashift);
+	const __m128i amask = _mm_set1_epi32(static_cast<int>(f->Amask));
+	const __m128i aone = _mm_set1_epi32(static_cast<int>(0xffu << f->Ashift));
+	const __m128i low = _mm_set1_epi32(0xff);
+	int i = 0;
+	for (; i + 4 <= n; i += 4){
+		__m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+		__m128i a = _mm_and_si128(_mm_srl_epi32(px, shift), low);
+		__m128i spread = _mm_or_si128(_mm_or_si128(a, _mm_slli_epi32(a, 8)), _mm_or_si128(_mm_slli_epi32(a, 16), _mm_slli_epi32(a, 24)));
+		__m128i factors = _mm_or_si128(_mm_andnot_si128(amask, spread), aone);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), mul_pixels_sse2(px, factors));
+	}
+	premultiply_row_scalar(row + i, n - i, f);
+}
+
+PIXELOPS_SSE2 static void color_key_row_sse2(uint32_t* row, int n, uint32_t key, uint32_t colormask, uint32_t amask){
+	const __m128i k = _mm_set1_epi32(static_cast<int>(key));
+	const __m128i cm = _mm_set1_epi32(static_cast<int>(colormask));
+	const __m128i am = _mm_set1_epi32(static_cast<int>(amask));
+	int i = 0;
+	for (; i + 4 <= n; i += 4){
+		__m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+		__m128i hit = _mm_cmpeq_epi32(_mm_and_si128(px, cm), k);
+		px = _mm_andnot_si128(_mm_and_si128(hit, am), px);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), px);
+	}
+	color_key_row_scalar(row + i, n - i, key, colormask, amask);
+}
+
+//one pixel as four 32 bit channels
+PIXELOPS_SSE2 static inline __m128i expand_pixel_sse2(uint32_t px){
+	const __m128i zero = _mm_setzero_si128();
+	return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(px)), zero), zero);
+}
+
+PIXELOPS_SSE2 static void blur_line_sse2(const uint32_t* src, int src_stride, uint32_t* dst, int dst_stride, int n, int radius, float inv){
+
+	const __m128 vinv = _mm_set1_ps(inv);
+	const __m128 half = _mm_set1_ps(0.5f);
+
+	__m128i sums = _mm_setzero_si128();
+	for (int k = -radius; k <= radius; k++){
+		sums = _mm_add_epi32(sums, expand_pixel_sse2(src[std::min(std::max(k, 0), n - 1) * src_stride]));
+	}
+
+	for (int i = 0; i < n; i++){
+
+		__m128i avg = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(sums), vinv), half));
+		avg = _mm_packs_epi32(avg, avg);
+		dst[i * dst_stride] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(avg, avg)));
+
+		__m128i leaving = expand_pixel_sse2(src[std::max(i - radius, 0) * src_stride]);
+		__m128i entering = expand_pixel_sse2(src[std::min(i + radius + 1, n - 1) * src_stride]);
+		sums = _mm_sub_epi32(_mm_add_epi32(sums, entering), leaving);
+
+	}
+
+}
+
+//AVX2 KERNELS
+PIXELOPS_AVX2 static inline __m256i mul_pixels_avx2(__m256i px, __m256i factors){
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i round = _mm256_set1_epi16(128);
+
+	__m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(px, zero), _mm256_unpacklo_epi8(factors, zero)), round);
+	__m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(px, zero), _mm256_unpackhi_epi8(factors, zero)), round);
+	lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+	hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+	//unpack and pack both work inside the 128 bit halves, so the pixel order stays the same
+	return _mm256_packus_epi16(lo, hi);
+}
+
+PIXELOPS_AVX2 static void tint_row_avx2(uint32_t* row, int n, uint32_t factors){
+	const __m256i f = _mm256_set1_epi32(static_cast<int>(factors));
+	int i = 0;
+	for (; i + 8 <= n; i += 8){
+		__m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), mul_pixels_avx2(px, f));
+	}
+	tint_row_scalar(row + i, n - i, factors);
+}
+
+PIXELOPS_AVX2 static void premultiply_row_avx2(uint32_t* row, int n, const SDL_PixelFormat* f){
+	const __m128i shift = _mm_cvtsi32_si128(f->Ashift);
+	const __m256i amask = _mm256_set1_epi32(static_cast<int>(f->Amask));
+	const __m256i aone = _mm256_set1_epi32(static_cast<int>(0xffu << f->Ashift));
+	const __m256i low = _mm256_set1_epi32(0xff);
+	const __m256i spread = _mm256_set1_epi32(0x01010101);
+	int i = 0;
+	for (; i + 8 <= n; i += 8){
+		__m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+		__m256i a = _mm256_and_si256(_mm256_srl_epi32(px, shift), low);
+		__m256i factors = _mm256_or_si256(_mm256_andnot_si256(amask, _mm256_mullo_epi32(a, spread)), aone);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), mul_pixels_avx2(px, factors));
+	}
+	premultiply_row_scalar(row + i, n - i, f);
+}
+
+PIXELOPS_AVX2 static void color_key_row_avx2(uint32_t* row, int n, uint32_t key, uint32_t colormask, uint32_t amask){
+	const __m256i k = _mm256_set1_epi32(static_cast<int>(key));
+	const __m256i cm = _mm256_set1_epi32(static_cast<int>(colormask));
+	const __m256i am = _mm256_set1_epi32(static_cast<int>(amask));
+	int i = 0;
+	for (; i + 8 <= n; i += 8){
+		__m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+		__m256i hit = _mm256_cmpeq_epi32(_mm256_and_si256(px, cm), k);
+		px = _mm256_andnot_si256(_mm256_and_si256(hit, am), px);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), px);
+	}
+	color_key_row_scalar(row + i, n - i, key, colormask, amask);
+}
+
+//two neighbouring pixels as eight 32 bit channels
+PIXELOPS_AVX2 static inline __m256i expand_pixel_pair_avx2(const uint32_t* px){
+	return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(px)));
+}
+
+//blurs the columns x and x+1 at once, so it is only used for the vertical pass
+PIXELOPS_AVX2 static void blur_column_pair_avx2(const uint32_t* src, int src_stride, uint32_t* dst, int dst_stride, int n, int radius, float inv){
+
+	const __m256 vinv = _mm256_set1_ps(inv);
+	const __m256 half = _mm256_set1_ps(0.5f);
+
+	__m256i sums = _mm256_setzero_si256();
+	for (int k = -radius; k <= radius; k++){
+		sums = _mm256_add_epi32(sums, expand_pixel_pair_avx2(src + std::min(std::max(k, 0), n - 1) * src_stride));
+	}
+
+	for (int i = 0; i < n; i++){
+
+		__m256i avg = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(sums), vinv), half));
+		__m128i words = _mm_packs_epi32(_mm256_castsi256_si128(avg), _mm256_extracti128_si256(avg, 1));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i * dst_stride), _mm_packus_epi16(words, words));
+
+		__m256i leaving = expand_pixel_pair_avx2(src + std::max(i - radius, 0) * src_stride);
+		__m256i entering = expand_pixel_pair_avx2(src + std::min(i + radius + 1, n - 1) * src_stride);
+		sums = _mm256_sub_epi32(_mm256_add_epi32(sums, entering), leaving);
+
+	}
+
+}
+
+#endif
+
+//DISPATCH
+static uint32_t* surface_row(SDL_Surface* s, int y){
+	return reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(s->pixels) + y * s->pitch);
+}
+
+void tint_pixels(SDL_Surface* s, uint8_t r, uint8_t g, uint8_t b){
+
+	if (!is_32bit(s)) return;
+
+	const SDL_PixelFormat* f = s->format;
+	uint32_t factors = ~(f->Rmask | f->Gmask | f->Bmask);//everything else stays
+	factors |= (static_cast<uint32_t>(r) << f->Rshift) | (static_cast<uint32_t>(g) << f->Gshift) | (static_cast<uint32_t>(b) << f->Bshift);
+
+	SDL_LockSurface(s);
+	for (int y = 0; y < s->h; y++){
+		uint32_t* row = surface_row(s, y);
+		switch (current_pixelops_level){
+#ifdef PIXELOPS_X86
+			case PIXELOPS_AVX2_LEVEL: tint_row_avx2(row, s->w, factors); break;
+			case PIXELOPS_SSE2_LEVEL: tint_row_sse2(row, s->w, factors); break;
+#endif
+			default: tint_row_scalar(row, s->w, factors); break;
+		}
+	}
+	SDL_UnlockSurface(s);
+
+}
+
+void premultiply_alpha(SDL_Surface* s){
+
+	if (!is_32bit(s) || s->format->Amask == 0) return;
+
+	SDL_LockSurface(s);
+	for (int y = 0; y < s->h; y++){
+		uint32_t* row = surface_row(s, y);
+		switch (current_pixelops_level){
+#ifdef PIXELOPS_X86
+			case PIXELOPS_AVX2_LEVEL: premultiply_row_avx2(row, s->w, s->format); break;
+			case PIXELOPS_SSE2_LEVEL: premultiply_row_sse2(row, s->w, s->format); break;
+#endif
+			default: premultiply_row_scalar(row, s->w, s->format); break;
+		}
+	}
+	SDL_UnlockSurface(s);
+
+}
+
+void color_key_pixels(SDL_Surface* s, uint8_t r, uint8_t g, uint8_t b){
+
+	if (!is_32bit(s) || s->format->Amask == 0) return;
+
+	const SDL_PixelFormat* f = s->format;
+	uint32_t colormask = f->Rmask | f->Gmask | f->Bmask;
+	uint32_t key = (static_cast<uint32_t>(r) << f->Rshift) | (static_cast<uint32_t>(g) << f->Gshift) | (static_cast<uint32_t>(b) << f->Bshift);
+
+	SDL_LockSurface(s);
+	for (int y = 0; y < s->h; y++){
+		uint32_t* row = surface_row(s, y);
+		switch (current_pixelops_level){
+#ifdef PIXELOPS_X86
+			case PIXELOPS_AVX2_LEVEL: color_key_row_avx2(row, s->w, key, colormask, f->Amask); break;
+			case PIXELOPS_SSE2_LEVEL: color_key_row_sse2(row, s->w, key, colormask, f->Amask); break;
+#endif
+			default: color_key_row_scalar(row, s->w, key, colormask, f->Amask); break;
+		}
+	}
+	SDL_UnlockSurface(s);
+
+}
+
+void box_blur_pixels(SDL_Surface* s, int radius){
+
+	if (!is_32bit(s) || radius <= 0 || s->w == 0 || s->h == 0) return;
+
+	const int w = s->w, h = s->h;
+	const int stride = s->pitch / 4;
+	const float inv = 1.0f / static_cast<float>(2 * radius + 1);
+	std::vector<uint32_t> tmp(static_cast<size_t>(w) * h);
+
+	SDL_LockSurface(s);
+	uint32_t* pixels = static_cast<uint32_t*>(s->pixels);
+
+	//horizontal pass into tmp
+	for (int y = 0; y < h; y++){
+		switch (current_pixelops_level){
+#ifdef PIXELOPS_X86
+			case PIXELOPS_AVX2_LEVEL:
+			case PIXELOPS_SSE2_LEVEL: blur_line_sse2(pixels + y * stride, 1, tmp.data() + y * w, 1, w, radius, inv); break;
+#endif
+			default: blur_line_scalar(pixels + y * stride, 1, tmp.data() + y * w, 1, w, radius, inv); break;
+		}
+	}
+
+	//vertical pass back into the surface
+	int x = 0;
+#ifdef PIXELOPS_X86
+	if (current_pixelops_level == PIXELOPS_AVX2_LEVEL){
+		for (; x + 2 <= w; x += 2) blur_column_pair_avx2(tmp.data() + x, w, pixels + x, stride, h, radius, inv);
+	}
+#endif
+	for (; x < w; x++){
+		switch (current_pixelops_level){
+#ifdef PIXELOPS_X86
+			case PIXELOPS_AVX2_LEVEL:
+			case PIXELOPS_SSE2_LEVEL: blur_line_sse2(tmp.data() + x, w, pixels + x, stride, h, radius, inv); break;
+#endif
+			default: blur_line_scalar(tmp.data() + x, w, pixels + x, stride, h, radius, inv); break;
+		}
+	}
+
+	SDL_UnlockSurface(s);
+
+}
+
+//TEXTURE VERSIONS
+//get_surface has detached the texture from the cache, so reload only uploads this texture
+static void upload_pixels(Texture& t){
+	if (t.is_streaming()) t.mark_dirty(SDL_Rect{0, 0, t.get_width(), t.get_height()});
+	else t.reload();
+}
+
+void tint_pixels(Texture& t, uint8_t r, uint8_t g, uint8_t b){
+	SDL_Surface* s = t.get_surface();
+	if (s == nullptr) return;
+	tint_pixels(s, r, g, b);
+	upload_pixels(t);
+}
+
+void premultiply_alpha(Texture& t){
+	SDL_Surface* s = t.get_surface();
+	if (s == nullptr) return;
+	premultiply_alpha(s);
+	upload_pixels(t);
+}
+
+void color_key_pixels(Texture& t, uint8_t r, uint8_t g, uint8_t b){
+	SDL_Surface* s = t.get_surface();
+	if (s == nullptr) return;
+	color_key_pixels(s, r, g, b);
+	upload_pixels(t);
+}
+
+void box_blur_pixels(Texture& t, int radius){
+	SDL_Surface* s = t.get_surface();
+	if (s == nullptr) return;
+	box_blur_pixels(s, radius);
+	upload_pixels(t);
+}
+
+#endif
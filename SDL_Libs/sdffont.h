@@ -0,0 +1,426 @@
+#ifndef __SDFFONT__
+#define __SDFFONT__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+#include <cinttypes>
+#include "window.h"
+#include "spritebatch.h"
+#include "fontcache.h"
+#include "glyphatlas.h"
+#include "textlayout.h"
+
+const int SDF_BASE_SIZE = 64;//point size the glyphs are rasterized at, once
+const int SDF_SPREAD = 8;//distance in base pixels stored around the outline
+const int SDF_MIN_BUCKET = -8, SDF_MAX_BUCKET = 4;//scales from 1/16 to 4 times the base size
+const float SDF_FAR = 1e20f;//squared distance of cells without a feature, finite so the transform does not produce nan
+
+/*
+*
+*	Text in any size out of one rasterization per glyph.
+*	Every glyph is rendered once at SDF_BASE_SIZE and turned into a signed distance field on the CPU.
+*	SDL_RenderGeometry can not threshold a distance field on the GPU, so the glyphs are made sharp per
+*	half octave of scale: for every scale that is drawn, the coverage is computed from the field and packed into pages.
+*	Sizes in between use the next bigger half octave, scaled down a bit by the renderer.
+*	No font is opened again and nothing is rasterized by SDL_ttf when the size changes.
+*
+*	Example usage:
+*		SdfFont* sdf = SdfFont::acquire("PATH.ttf", &window);
+*		sdf->draw("Zoomed label", x, y, 28.0f * camera_zoom, color);
+*		SdfFont::release(sdf);
+*
+*	Usually used through Font::set_sdf_mode.
+*
+*/
+
+struct SdfGlyph{
+	std::vector<uint8_t> field;//128 is the outline, bigger values are inside
+	int w = 0, h = 0;//size of the field, the rendered glyph plus SDF_SPREAD on every side
+	int advance = 0;
+};
+
+//the glyphs of one half octave of scale
+struct SdfBucket{
+
+	GlyphPages pages;
+	std::unordered_map<uint32_t, Glyph> glyphs;
+
+	SdfBucket(SDL_Renderer* r): pages(r){}
+
+};
+
+class SdfFont{
+
+protected:
+
+	Window* window = nullptr;
+	TTF_Font* font = nullptr;//at SDF_BASE_SIZE
+	std::string path;
+
+	std::unordered_map<uint32_t, SdfGlyph> fields;
+	std::map<int, SdfBucket*> buckets;
+	SpriteBatch batch;
+
+	unsigned int references = 0;
+	static std::unordered_map<std::string, SdfFont*>& fonts();
+	static std::string font_key(const std::string& path, SDL_Renderer* r);
+
+	const SdfGlyph& field(uint32_t codepoint);
+	const Glyph& glyph(int bucket, uint32_t codepoint);
+	int bucket_for(float scale) const;
+	float bucket_scale(int bucket) const;
+
+public:
+
+	SdfFont(const std::string& path, Window* window_ptr);
+	virtual ~SdfFont();
+
+	//one shared font per path and renderer
+	static SdfFont* acquire(const std::string& path, Window* window_ptr);
+	static void release(SdfFont*);
+
+	//the font at SDF_BASE_SIZE, for laying out text with TextLayout
+	TTF_Font* get_font() const;
+
+	void measure(const std::string& utf8, float size, int& w, int& h);
+	//size is the point size to draw at, x and y are the top left corner
+	void add(SpriteBatch& b, const std::string& utf8, float x, float y, float size, const SDL_Color& c=GLYPH_WHITE, SDL_BlendMode bm=STANDARD_BLENDMODE);
+	void add(SpriteBatch& b, const Paragraph& p, float x, float y, float size, const SDL_Color& c=GLYPH_WHITE, SDL_BlendMode bm=STANDARD_BLENDMODE);
+	void draw(const std::string& utf8, int x, int y, float size, const SDL_Color& c=GLYPH_WHITE, SDL_BlendMode bm=STANDARD_BLENDMODE);
+	void draw(const Paragraph& p, int x, int y, float size, const SDL_Color& c=GLYPH_WHITE, SDL_BlendMode bm=STANDARD_BLENDMODE);
+
+	//the distance fields on the CPU and the pages of all scales on the GPU
+	size_t memory_bytes() const;
+	unsigned int bucket_count() const;
+
+	SdfFont(const SdfFont&) = delete;
+	SdfFont& operator=(const SdfFont&) = delete;
+
+};
+
+//IMPLEMENTATION
+
+//squared distance transform of one line (Felzenszwalb and Huttenlocher), f is 0 on features and SDF_FAR elsewhere
+static void sdf_transform_line(const float* f, int n, float* d, int* v, float* z){
+
+	const float inf = std::numeric_limits<float>::infinity();
+
+	int k = 0;
+	v[0] = 0;
+	z[0] = -inf;
+	z[1] = inf;
+
+	for (int q = 1; q < n; q++){
+		float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+		while (s <= z[k]){
+			k--;
+			s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2.0f * q - 2.0f * v[k]);
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = inf;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; q++){
+		while (z[k + 1] < q) k++;
+		d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+	}
+
+}
+
+//squared distance of every cell to the nearest feature cell, in place
+static void sdf_transform(std::vector<float>& grid, int w, int h){
+
+	int n = std::max(w, h);
+	std::vector<float> f(n), d(n), z(n + 1);
+	std::vector<int> v(n);
+
+	for (int x = 0; x < w; x++){
+		for (int y = 0; y < h; y++) f[y] = grid[y * w + x];
+		sdf_transform_line(f.data(), h, d.data(), v.data(), z.data());
+		for (int y = 0; y < h; y++) grid[y * w + x] = d[y];
+	}
+
+	for (int y = 0; y < h; y++){
+		sdf_transform_line(&grid[y * w], w, d.data(), v.data(), z.data());
+		std::copy(d.begin(), d.begin() + w, grid.begin() + y * w);
+	}
+
+}
+
+SdfFont::SdfFont(const std::string& path, Window* window_ptr): batch(window_ptr){
+
+	this->path = path;
+	this->window = window_ptr;
+	font = FontCache::instance().acquire(path, SDF_BASE_SIZE);
+
+}
+
+SdfFont::~SdfFont(){
+
+	for (auto& b : buckets) delete b.second;
+	FontCache::instance().release(font);
+
+}
+
+std::unordered_map<std::string, SdfFont*>& SdfFont::fonts(){
+	static std::unordered_map<std::string, SdfFont*> all;
+	return all;
+}
+
+std::string SdfFont::font_key(const std::string& path, SDL_Renderer* r){
+	return path + ":" + std::to_string(reinterpret_cast<uintptr_t>(r));
+}
+
+SdfFont* SdfFont::acquire(const std::string& path, Window* window_ptr){
+
+	if (window_ptr == nullptr) return nullptr;
+
+	SdfFont*& sdf = fonts()[font_key(path, window_ptr->renderer)];
+	if (sdf == nullptr) sdf = new SdfFont(path, window_ptr);
+
+	sdf->references += 1;
+	return sdf;
+
+}
+
+void SdfFont::release(SdfFont* sdf){
+
+	if (sdf == nullptr) return;
+	if (sdf->references > 1){
+		sdf->references -= 1;
+		return;
+	}
+
+	fonts().erase(font_key(sdf->path, sdf->window->renderer));
+	delete sdf;
+
+}
+
+TTF_Font* SdfFont::get_font() const{
+	return font;
+}
+
+const SdfGlyph& SdfFont::field(uint32_t codepoint){
+
+	auto it = fields.find(codepoint);
+	if (it != fields.end()) return it->second;
+
+	SdfGlyph& g = fields[codepoint];
+	if (font == nullptr || codepoint > 0xffff) return g;
+	Uint16 ch = static_cast<Uint16>(codepoint);
+
+	int minx, maxx, miny, maxy;
+	if (TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &g.advance) != 0) return g;
+
+	SDL_Surface* rendered = TTF_RenderGlyph_Blended(font, ch, GLYPH_WHITE);
+	if (rendered == nullptr) return g;
+	SDL_Surface* s = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_FreeSurface(rendered);
+	if (s == nullptr) return g;
+
+	g.w = s->w + 2 * SDF_SPREAD;
+	g.h = s->h + 2 * SDF_SPREAD;
+
+	//to_inside is 0 on the glyph, to_outside is 0 around it
+	std::vector<float> to_inside(static_cast<size_t>(g.w) * g.h, SDF_FAR), to_outside(static_cast<size_t>(g.w) * g.h, 0.0f);
+	for (int y = 0; y < s->h; y++){
+		const uint32_t* row = reinterpret_cast<const uint32_t*>(static_cast<const uint8_t*>(s->pixels) + y * s->pitch);
+		for (int x = 0; x < s->w; x++){
+			if ((row[x] >> 24) < 128) continue;
+			size_t i = static_cast<size_t>(y + SDF_SPREAD) * g.w + x + SDF_SPREAD;
+			to_inside[i] = 0.0f;
+			to_outside[i] = SDF_FAR;
+		}
+	}
+	SDL_FreeSurface(s);
+
+	sdf_transform(to_inside, g.w, g.h);
+	sdf_transform(to_outside, g.w, g.h);
+
+	//the outline lies half a pixel from the pixel centers on either side
+	g.field.resize(to_inside.size());
+	for (size_t i = 0; i < g.field.size(); i++){
+		float distance = (to_outside[i] > 0.0f) ? 0.5f - std::sqrt(to_outside[i]) : std::sqrt(to_inside[i]) - 0.5f;
+		float v = 128.0f - distance * 127.0f / SDF_SPREAD;
+		g.field[i] = static_cast<uint8_t>(std::min(std::max(v, 0.0f), 255.0f));
+	}
+
+	return g;
+
+}
+
+int SdfFont::bucket_for(float scale) const{
+	//the next bigger half octave, so glyphs are only ever scaled down
+	int b = static_cast<int>(std::ceil(2.0f * std::log2(scale) - 0.001f));
+	return std::min(std::max(b, SDF_MIN_BUCKET), SDF_MAX_BUCKET);
+}
+
+float SdfFont::bucket_scale(int bucket) const{
+	return std::pow(2.0f, bucket * 0.5f);
+}
+
+const Glyph& SdfFont::glyph(int bucket, uint32_t codepoint){
+
+	SdfBucket*& b = buckets[bucket];
+	if (b == nullptr) b = new SdfBucket(window->renderer);
+
+	auto it = b->glyphs.find(codepoint);
+	if (it != b->glyphs.end()) return it->second;
+
+	const SdfGlyph& f = field(codepoint);
+	Glyph& g = b->glyphs[codepoint];
+	g.page = 0;
+	g.rect = SDL_Rect{0, 0, 0, 0};
+	g.advance = f.advance;
+	if (f.field.empty()) return g;
+
+	float scale = bucket_scale(bucket);
+	int w = std::max(static_cast<int>(std::ceil(f.w * scale)), 1), h = std::max(static_cast<int>(std::ceil(f.h * scale)), 1);
+
+	SDL_Surface* s = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (s == nullptr) return g;
+
+	for (int y = 0; y < h; y++){
+
+		uint32_t* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(s->pixels) + y * s->pitch);
+		float fy = std::min(std::max((y + 0.5f) / scale - 0.5f, 0.0f), f.h - 1.0f);
+		int y0 = static_cast<int>(fy), y1 = std::min(y0 + 1, f.h - 1);
+		float ty = fy - y0;
+
+		for (int x = 0; x < w; x++){
+
+			float fx = std::min(std::max((x + 0.5f) / scale - 0.5f, 0.0f), f.w - 1.0f);
+			int x0 = static_cast<int>(fx), x1 = std::min(x0 + 1, f.w - 1);
+			float tx = fx - x0;
+
+			float top = f.field[y0 * f.w + x0] * (1.0f - tx) + f.field[y0 * f.w + x1] * tx;
+			float bottom = f.field[y1 * f.w + x0] * (1.0f - tx) + f.field[y1 * f.w + x1] * tx;
+			float v = top * (1.0f - ty) + bottom * ty;
+
+			//distance in pixels of this scale, one pixel wide edge
+			float distance = (128.0f - v) * SDF_SPREAD / 127.0f * scale;
+			float coverage = std::min(std::max(0.5f - distance, 0.0f), 1.0f);
+			row[x] = (static_cast<uint32_t>(coverage * 255.0f + 0.5f) << 24) | 0x00ffffff;
+
+		}
+
+	}
+
+	if (!b->pages.pack(s, g.page, g.rect)) g.rect = SDL_Rect{0, 0, 0, 0};
+	SDL_FreeSurface(s);
+
+	return g;
+
+}
+
+void SdfFont::measure(const std::string& utf8, float size, int& w, int& h){
+
+	float scale = size / SDF_BASE_SIZE;
+	float pen = 0.0f;
+	uint32_t previous = 0;
+	size_t i = 0;
+
+	while (i < utf8.size()){
+		uint32_t cp = next_codepoint(utf8, i);
+		if (previous != 0 && font != nullptr && previous <= 0xffff && cp <= 0xffff){
+			pen += TTF_GetFontKerningSizeGlyphs(font, static_cast<Uint16>(previous), static_cast<Uint16>(cp)) * scale;
+		}
+		pen += field(cp).advance * scale;
+		previous = cp;
+	}
+
+	w = static_cast<int>(std::ceil(pen));
+	h = (font != nullptr) ? static_cast<int>(std::ceil(TTF_FontHeight(font) * scale)) : 0;
+
+}
+
+void SdfFont::add(SpriteBatch& b, const std::string& utf8, float x, float y, float size, const SDL_Color& c, SDL_BlendMode bm){
+
+	if (window == nullptr || size <= 0.0f) return;
+
+	float scale = size / SDF_BASE_SIZE;
+	int bucket = bucket_for(scale);
+	float quad_scale = scale / bucket_scale(bucket);
+
+	float pen = x;
+	uint32_t previous = 0;
+	size_t i = 0;
+
+	while (i < utf8.size()){
+
+		uint32_t cp = next_codepoint(utf8, i);
+		if (previous != 0 && font != nullptr && previous <= 0xffff && cp <= 0xffff){
+			pen += TTF_GetFontKerningSizeGlyphs(font, static_cast<Uint16>(previous), static_cast<Uint16>(cp)) * scale;
+		}
+
+		const Glyph& g = glyph(bucket, cp);
+		if (g.rect.w > 0 && g.rect.h > 0){
+			//the field reaches SDF_SPREAD base pixels past the rendered glyph
+			SDL_FRect dst = {pen - SDF_SPREAD * scale, y - SDF_SPREAD * scale, g.rect.w * quad_scale, g.rect.h * quad_scale};
+			b.add(buckets[bucket]->pages.get(g.page), &g.rect, dst, 0.0, nullptr, SDL_FLIP_NONE, c, bm);
+		}
+
+		pen += g.advance * scale;
+		previous = cp;
+
+	}
+
+}
+
+void SdfFont::add(SpriteBatch& b, const Paragraph& p, float x, float y, float size, const SDL_Color& c, SDL_BlendMode bm){
+
+	//paragraphs are laid out with the base font
+	float scale = size / SDF_BASE_SIZE;
+	for (const LayoutLine& line : p.lines){
+		add(b, line.text, x + line.x * scale, y + line.y * scale, size, c, bm);
+	}
+
+}
+
+void SdfFont::draw(const std::string& utf8, int x, int y, float size, const SDL_Color& c, SDL_BlendMode bm){
+	batch.begin();
+	add(batch, utf8, static_cast<float>(x), static_cast<float>(y), size, c, bm);
+	batch.end();
+}
+
+void SdfFont::draw(const Paragraph& p, int x, int y, float size, const SDL_Color& c, SDL_BlendMode bm){
+	batch.begin();
+	add(batch, p, static_cast<float>(x), static_cast<float>(y), size, c, bm);
+	batch.end();
+}
+
+size_t SdfFont::memory_bytes() const{
+
+	size_t bytes = 0;
+	for (auto& f : fields) bytes += f.second.field.size();
+	for (auto& b : buckets) bytes += b.second->pages.bytes();
+	return bytes;
+
+}
+
+unsigned int SdfFont::bucket_count() const{
+	return static_cast<unsigned int>(buckets.size());
+}
+
+#endif
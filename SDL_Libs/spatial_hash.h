@@ -0,0 +1,288 @@
+#ifndef __SPATIAL_HASH__
+#define __SPATIAL_HASH__
+
+#include <vector>
+#include <utility>
+#include <cinttypes>
+#include <unordered_map>
+#include "gameobject.h"
+
+const int STANDARD_CELL_SIZE = 64;//in pixels, about the size of a typical object works best
+
+typedef std::pair<GameObject2D*, GameObject2D*> CollisionPair;
+
+/*
+*
+*	Uniform grid over the bounds of GameObject2D hitboxes.
+*	Objects are stored in every cell their bounds touch and only move between cells when their hitboxes
+*	change (update_hitboxes tells the world). Checks are only done between objects sharing a cell,
+*	so finding all collisions costs about the number of objects instead of its square.
+*
+*	Example usage:
+*		SpatialHash world(64);
+*		world.insert(&player);
+*		for (Enemy& e : enemies) world.insert(&e);
+*		//in the game loop, after moving
+*		world.pairs(collisions);//every pair of objects whose hitboxes hit
+*		world.neighbors(&player, near);//objects that might hit the player
+*
+*	Objects much bigger than the cell size land in many cells, for scenes like that a CollisionTree fits better.
+*
+*/
+
+struct HashEntry{
+	GameObject2D* object;
+	HitboxBounds bounds;
+	int cx0, cy0, cx1, cy1;//range of cells the object is in
+	bool placed;//false for objects without hitboxes
+	unsigned int stamp;//last query that returned the object
+};
+
+class SpatialHash: public CollisionWorld{
+
+protected:
+
+	int cell_size = STANDARD_CELL_SIZE;
+
+	std::unordered_map<uint64_t, std::vector<HashEntry*>> cells;
+	std::unordered_map<GameObject2D*, HashEntry*> entries;
+	unsigned int stamp = 0;
+
+	int cell_of(int coordinate) const;
+	static uint64_t cell_key(int cx, int cy);
+
+	void place(HashEntry*);
+	void unplace(HashEntry*);
+
+	//every entry once whose bounds overlap, except skip
+	void collect(const HitboxBounds&, const GameObject2D* skip, std::vector<GameObject2D*>& out);
+
+public:
+
+	SpatialHash(int cell_size=STANDARD_CELL_SIZE);
+	virtual ~SpatialHash();
+
+	void insert(GameObject2D*);
+	void remove(GameObject2D*);
+	void update(GameObject2D*);
+	void clear();
+
+	//all pairs with overlapping bounds, exact also checks their hitboxes with GameObject2D::hits
+	void pairs(std::vector<CollisionPair>& out, bool exact=true);
+	//objects whose bounds overlap the area
+	void query(const HitboxBounds& area, std::vector<GameObject2D*>& out);
+	//objects that might hit obj, without obj itself
+	void neighbors(GameObject2D* obj, std::vector<GameObject2D*>& out);
+
+	size_t size() const;
+	//cells that hold at least one object
+	size_t cell_count() const;
+	int get_cell_size() const;
+
+	SpatialHash(const SpatialHash&) = delete;
+	SpatialHash& operator=(const SpatialHash&) = delete;
+
+};
+
+//IMPLEMENTATION
+SpatialHash::SpatialHash(int cell_size){
+	this->cell_size = (cell_size > 0) ? cell_size : STANDARD_CELL_SIZE;
+}
+
+SpatialHash::~SpatialHash(){
+	clear();
+}
+
+int SpatialHash::cell_of(int coordinate) const{
+	//rounding down, also for negative coordinates
+	return (coordinate >= 0) ? coordinate / cell_size : -((-coordinate - 1) / cell_size) - 1;
+}
+
+uint64_t SpatialHash::cell_key(int cx, int cy){
+	return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+}
+
+void SpatialHash::place(HashEntry* e){
+
+	e->placed = e->object->get_bounds(e->bounds);
+	if (!e->placed) return;
+
+	//right and bottom are exclusive, empty bounds still get their one cell
+	e->cx0 = cell_of(e->bounds.left);
+	e->cy0 = cell_of(e->bounds.top);
+	e->cx1 = cell_of(std::max(e->bounds.right - 1, e->bounds.left));
+	e->cy1 = cell_of(std::max(e->bounds.bottom - 1, e->bounds.top));
+
+	for (int cx = e->cx0; cx <= e->cx1; cx++){
+		for (int cy = e->cy0; cy <= e->cy1; cy++) cells[cell_key(cx, cy)].push_back(e);
+	}
+
+}
+
+void SpatialHash::unplace(HashEntry* e){
+
+	if (!e->placed) return;
+
+	for (int cx = e->cx0; cx <= e->cx1; cx++){
+		for (int cy = e->cy0; cy <= e->cy1; cy++){
+
+			auto it = cells.find(cell_key(cx, cy));
+			if (it == cells.end()) continue;
+
+			std::vector<HashEntry*>& cell = it->second;
+			for (size_t i = 0; i < cell.size(); i++){
+				if (cell[i] != e) continue;
+				cell[i] = cell.back();
+				cell.pop_back();
+				break;
+			}
+			if (cell.empty()) cells.erase(it);
+
+		}
+	}
+	e->placed = false;
+
+}
+
+void SpatialHash::insert(GameObject2D* obj){
+
+	if (obj == nullptr || entries.count(obj) != 0) return;
+	if (obj->get_world() != nullptr) obj->get_world()->remove(obj);
+
+	HashEntry* e = new HashEntry;
+	e->object = obj;
+	e->placed = false;
+	e->stamp = 0;
+	entries[obj] = e;
+
+	attach(obj, this);
+	place(e);
+
+}
+
+void SpatialHash::remove(GameObject2D* obj){
+
+	auto it = entries.find(obj);
+	if (it == entries.end()) return;
+
+	unplace(it->second);
+	delete it->second;
+	entries.erase(it);
+	attach(obj, nullptr);
+
+}
+
+void SpatialHash::update(GameObject2D* obj){
+
+	auto it = entries.find(obj);
+	if (it == entries.end()) return;
+	HashEntry* e = it->second;
+
+	HitboxBounds b;
+	bool has_bounds = obj->get_bounds(b);
+
+	//small moves inside the same cells only change the stored bounds
+	if (has_bounds && e->placed && cell_of(b.left) == e->cx0 && cell_of(b.top) == e->cy0
+		&& cell_of(std::max(b.right - 1, b.left)) == e->cx1 && cell_of(std::max(b.bottom - 1, b.top)) == e->cy1){
+		e->bounds = b;
+		return;
+	}
+
+	unplace(e);
+	place(e);
+
+}
+
+void SpatialHash::clear(){
+
+	for (auto& e : entries){
+		attach(e.first, nullptr);
+		delete e.second;
+	}
+	entries.clear();
+	cells.clear();
+
+}
+
+void SpatialHash::pairs(std::vector<CollisionPair>& out, bool exact){
+
+	out.clear();
+
+	for (auto& c : cells){
+
+		int cx = static_cast<int>(static_cast<uint32_t>(c.first >> 32));
+		int cy = static_cast<int>(static_cast<uint32_t>(c.first));
+		const std::vector<HashEntry*>& cell = c.second;
+
+		for (size_t i = 0; i < cell.size(); i++){
+			for (size_t j = i + 1; j < cell.size(); j++){
+
+				HashEntry* a = cell[i];
+				HashEntry* b = cell[j];
+
+				//a pair sharing several cells is only reported in the first of them
+				if (cx != std::max(a->cx0, b->cx0) || cy != std::max(a->cy0, b->cy0)) continue;
+				if (!bounds_overlap(a->bounds, b->bounds)) continue;
+				if (exact && !a->object->hits(b->object)) continue;
+
+				out.push_back(CollisionPair(a->object, b->object));
+
+			}
+		}
+
+	}
+
+}
+
+void SpatialHash::collect(const HitboxBounds& area, const GameObject2D* skip, std::vector<GameObject2D*>& out){
+
+	stamp += 1;
+
+	int cx0 = cell_of(area.left), cy0 = cell_of(area.top);
+	int cx1 = cell_of(std::max(area.right - 1, area.left)), cy1 = cell_of(std::max(area.bottom - 1, area.top));
+
+	for (int cx = cx0; cx <= cx1; cx++){
+		for (int cy = cy0; cy <= cy1; cy++){
+
+			auto it = cells.find(cell_key(cx, cy));
+			if (it == cells.end()) continue;
+
+			for (HashEntry* e : it->second){
+				if (e->stamp == stamp || e->object == skip) continue;
+				e->stamp = stamp;
+				if (bounds_overlap(e->bounds, area)) out.push_back(e->object);
+			}
+
+		}
+	}
+
+}
+
+void SpatialHash::query(const HitboxBounds& area, std::vector<GameObject2D*>& out){
+	out.clear();
+	collect(area, nullptr, out);
+}
+
+void SpatialHash::neighbors(GameObject2D* obj, std::vector<GameObject2D*>& out){
+
+	out.clear();
+
+	auto it = entries.find(obj);
+	if (it == entries.end() || !it->second->placed) return;
+	collect(it->second->bounds, obj, out);
+
+}
+
+size_t SpatialHash::size() const{
+	return entries.size();
+}
+
+size_t SpatialHash::cell_count() const{
+	return cells.size();
+}
+
+int SpatialHash::get_cell_size() const{
+	return cell_size;
+}
+
+#endif
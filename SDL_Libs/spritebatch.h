@@ -0,0 +1,249 @@
+#ifndef __SPRITEBATCH__
+#define __SPRITEBATCH__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cinttypes>
+#include "window.h"
+#include "texture.h"
+#include "atlas.h"
+
+const SDL_Color BATCH_WHITE = {0xff, 0xff, 0xff, 0xff};
+const size_t STANDARD_BATCH_SIZE = 1024;//sprites reserved up front
+const double BATCH_PI = 3.14159265358979323846;
+
+/*
+*
+*	Collects sprites as quads and draws all sprites of the same texture and blendmode with one SDL_RenderGeometry call.
+*	Works best together with a TextureAtlas, where many sprites share one page.
+*
+*	Example usage:
+*		SpriteBatch batch(&window);
+*		//in the game loop
+*		batch.begin();
+*		for (Texture& t : textures) batch.add(t, x, y);
+*		batch.end();
+*
+*/
+
+class SpriteBatch{
+
+protected:
+
+	Window* window = nullptr;
+
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;
+
+	SDL_Texture* current = nullptr;//texture of the quads waiting in the buffers
+	SDL_BlendMode current_blendmode = STANDARD_BLENDMODE;
+	float texture_w = 1.0f, texture_h = 1.0f;
+
+	unsigned int draw_calls = 0, sprites = 0;//since the last begin
+	bool begun = false;
+
+public:
+
+	SpriteBatch(Window* window_ptr, size_t reserve=STANDARD_BATCH_SIZE);
+	virtual ~SpriteBatch();
+
+	void begin();
+	//adds a quad, the angle is in degrees around center (relative to dst, nullptr means the middle) like SDL_RenderCopyEx
+	void add(SDL_Texture* t, const SDL_Rect* clip, const SDL_FRect& dst, double angle=0.0, const SDL_FPoint* center=nullptr, SDL_RendererFlip flip=STANDARD_FLIPTYPE, const SDL_Color& c=BATCH_WHITE, SDL_BlendMode b=STANDARD_BLENDMODE);
+	//same as Texture::draw and AtlasSprite::draw, just batched
+	void add(const Texture& t);
+	void add(const Texture& t, int x, int y, int w=-1, int h=-1);
+	void add(const AtlasSprite& s, int x, int y, int w=-1, int h=-1);
+	//draws everything that is waiting
+	void flush();
+	void end();
+
+	unsigned int get_draw_calls() const;
+	unsigned int get_sprites() const;
+
+};
+
+SpriteBatch::SpriteBatch(Window* window_ptr, size_t reserve){
+	this->window = window_ptr;
+	vertices.reserve(reserve * 4);
+	indices.reserve(reserve * 6);
+}
+
+SpriteBatch::~SpriteBatch(){
+	if (begun) TextureCache::instance().release_evictions();
+}
+
+void SpriteBatch::begin(){
+	//the buffered quads keep raw texture pointers, so the cache must not evict anything until end
+	if (!begun) TextureCache::instance().hold_evictions();
+	begun = true;
+	vertices.clear();
+	indices.clear();
+	current = nullptr;
+	draw_calls = 0;
+	sprites = 0;
+}
+
+void SpriteBatch::add(SDL_Texture* t, const SDL_Rect* clip, const SDL_FRect& dst, double angle, const SDL_FPoint* center, SDL_RendererFlip flip, const SDL_Color& c, SDL_BlendMode b){
+
+	if (window == nullptr || t == nullptr) return;
+
+	if (t != current || b != current_blendmode){
+		flush();
+		current = t;
+		current_blendmode = b;
+		int w = 1, h = 1;
+		SDL_QueryTexture(t, nullptr, nullptr, &w, &h);
+		texture_w = static_cast<float>(w);
+		texture_h = static_cast<float>(h);
+	}
+
+	float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+	if (clip != nullptr){
+		u0 = clip->x / texture_w;
+		v0 = clip->y / texture_h;
+		u1 = (clip->x + clip->w) / texture_w;
+		v1 = (clip->y + clip->h) / texture_h;
+	}
+	if (flip & SDL_FLIP_HORIZONTAL) std::swap(u0, u1);
+	if (flip & SDL_FLIP_VERTICAL) std::swap(v0, v1);
+
+	float cx = (center != nullptr) ? center->x : dst.w * 0.5f;
+	float cy = (center != nullptr) ? center->y : dst.h * 0.5f;
+
+	//corners relative to the rotation center
+	float px[4] = {-cx, dst.w - cx, dst.w - cx, -cx};
+	float py[4] = {-cy, -cy, dst.h - cy, dst.h - cy};
+	float us[4] = {u0, u1, u1, u0};
+	float vs[4] = {v0, v0, v1, v1};
+
+	float sn = 0.0f, cs = 1.0f;
+	if (angle != 0.0){
+		double rad = angle * BATCH_PI / 180.0;
+		sn = static_cast<float>(std::sin(rad));
+		cs = static_cast<float>(std::cos(rad));
+	}
+
+	int first = static_cast<int>(vertices.size());
+	for (int i = 0; i < 4; i++){
+		SDL_Vertex v;
+		v.position.x = dst.x + cx + px[i] * cs - py[i] * sn;
+		v.position.y = dst.y + cy + px[i] * sn + py[i] * cs;
+		v.color = c;
+		v.tex_coord.x = us[i];
+		v.tex_coord.y = vs[i];
+		vertices.push_back(v);
+	}
+
+	indices.push_back(first);
+	indices.push_back(first + 1);
+	indices.push_back(first + 2);
+	indices.push_back(first);
+	indices.push_back(first + 2);
+	indices.push_back(first + 3);
+
+	sprites += 1;
+
+}
+
+void SpriteBatch::add(const Texture& t){
+
+	SDL_Texture* st = t.drawn_texture();
+	if (st == nullptr) return;
+
+	SDL_FRect dst;
+	if (t.renderrect != nullptr){
+		dst = SDL_FRect{static_cast<float>(t.renderrect->x), static_cast<float>(t.renderrect->y), static_cast<float>(t.renderrect->w), static_cast<float>(t.renderrect->h)};
+	}
+	else{
+		//like SDL_RenderCopyEx, no renderrect means the whole target
+		int w = 0, h = 0;
+		SDL_GetRendererOutputSize(window->renderer, &w, &h);
+		dst = SDL_FRect{0.0f, 0.0f, static_cast<float>(w), static_cast<float>(h)};
+	}
+
+	SDL_FPoint c;
+	if (t.center != nullptr) c = SDL_FPoint{static_cast<float>(t.center->x), static_cast<float>(t.center->y)};
+	SDL_Color color = {t.r, t.g, t.b, t.alpha};
+
+	add(st, (t.pending == nullptr && t.clipped) ? &t.cliprect : nullptr, dst, t.angle, t.center != nullptr ? &c : nullptr, t.flipType, color, t.blendmode);
+
+}
+
+void SpriteBatch::add(const Texture& t, int x, int y, int w, int h){
+
+	SDL_Texture* st = t.drawn_texture();
+	if (st == nullptr) return;
+
+	if (w == -1) w = t.width;
+	if (h == -1) h = t.height;
+	SDL_FRect dst = {static_cast<float>(x), static_cast<float>(y), static_cast<float>(w), static_cast<float>(h)};
+
+	SDL_FPoint c;
+	if (t.center != nullptr) c = SDL_FPoint{static_cast<float>(t.center->x), static_cast<float>(t.center->y)};
+	SDL_Color color = {t.r, t.g, t.b, t.alpha};
+
+	add(st, (t.pending == nullptr && t.clipped) ? &t.cliprect : nullptr, dst, t.angle, t.center != nullptr ? &c : nullptr, t.flipType, color, t.blendmode);
+
+}
+
+void SpriteBatch::add(const AtlasSprite& s, int x, int y, int w, int h){
+
+	if (w == -1) w = s.cliprect.w;
+	if (h == -1) h = s.cliprect.h;
+	SDL_FRect dst = {static_cast<float>(x), static_cast<float>(y), static_cast<float>(w), static_cast<float>(h)};
+
+	SDL_FPoint c = {static_cast<float>(s.center.x), static_cast<float>(s.center.y)};
+	SDL_Color color = {s.r, s.g, s.b, s.alpha};
+
+	add(s.page, &s.cliprect, dst, s.angle, s.has_center ? &c : nullptr, s.flipType, color, s.blendmode);
+
+}
+
+void SpriteBatch::flush(){
+
+	if (current == nullptr || indices.empty()) return;
+
+	//the color is in the vertices, the modulation of a Texture gets set again on its next draw
+	SDL_SetTextureColorMod(current, 0xff, 0xff, 0xff);
+	SDL_SetTextureAlphaMod(current, 0xff);
+	SDL_SetTextureBlendMode(current, current_blendmode);
+
+	SDL_RenderGeometry(window->renderer, current, vertices.data(), static_cast<int>(vertices.size()), indices.data(), static_cast<int>(indices.size()));
+	draw_calls += 1;
+
+	vertices.clear();
+	indices.clear();
+
+}
+
+void SpriteBatch::end(){
+	flush();
+	current = nullptr;
+	if (begun) TextureCache::instance().release_evictions();
+	begun = false;
+}
+
+unsigned int SpriteBatch::get_draw_calls() const{
+	return draw_calls;
+}
+
+unsigned int SpriteBatch::get_sprites() const{
+	return sprites;
+}
+
+#endif
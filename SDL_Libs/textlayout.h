@@ -0,0 +1,279 @@
+#ifndef __TEXTLAYOUT__
+#define __TEXTLAYOUT__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include "fontcache.h"
+
+const size_t STANDARD_PARAGRAPH_CACHE = 256;//paragraphs kept before the cache starts over
+
+/*
+*
+*	Measures and wraps text without rendering it.
+*	Laid out paragraphs are cached by (text, font, width, alignment), so laying out the same dialog again is a lookup.
+*
+*	Example usage:
+*		TTF_Font* font = FontCache::instance().acquire("PATH.ttf", 28);
+*		const Paragraph& p = mainTextLayout.layout(font, "A long dialog text ...", 300, ALIGN_CENTER);
+*		for (const LayoutLine& line : p.lines) //line.text goes to x + line.x, y + line.y
+*
+*	A returned paragraph stays valid until the next call to layout.
+*
+*/
+
+enum TextAlign{
+				ALIGN_LEFT,
+				ALIGN_CENTER,
+				ALIGN_RIGHT
+			};
+
+struct LayoutLine{
+	std::string text;
+	int x, y;//relative to the top left corner of the paragraph
+	int width;
+};
+
+struct Paragraph{
+	std::string text;
+	std::vector<LayoutLine> lines;
+	int width = 0, height = 0;//lines are aligned inside the widest line
+};
+
+struct ParagraphKey{
+
+	size_t text_hash;
+	std::string font;
+	int width;
+	int align;
+
+	bool operator==(const ParagraphKey& other) const{
+		return text_hash == other.text_hash && width == other.width && align == other.align && font == other.font;
+	}
+
+};
+
+struct ParagraphKeyHash{
+
+	size_t operator()(const ParagraphKey& k) const{
+		size_t h = k.text_hash;
+		h ^= std::hash<std::string>()(k.font) + 0x9e3779b9 + (h << 6) + (h >> 2);
+		h ^= std::hash<int>()(k.width * 4 + k.align) + 0x9e3779b9 + (h << 6) + (h >> 2);
+		return h;
+	}
+
+};
+
+class TextLayout{
+
+protected:
+
+	std::unordered_map<ParagraphKey, Paragraph, ParagraphKeyHash> paragraphs;
+	std::unordered_map<std::string, int> widths;//font name + '\n' + run
+	size_t max_paragraphs = STANDARD_PARAGRAPH_CACHE;
+
+	unsigned int hits = 0, misses = 0;
+
+	//a name that stays the same for the same font file and size
+	std::string font_name(TTF_Font*) const;
+	int cached_width(TTF_Font*, const std::string& name, const std::string& run);
+	void add_line(TTF_Font*, Paragraph&, const std::string& text);
+	//splits a word wider than max_width between codepoints, the rest that fits stays in line
+	void break_word(TTF_Font*, Paragraph&, const std::string& word, int max_width, std::string& line, int& line_width);
+
+public:
+
+	TextLayout(size_t max_paragraphs=STANDARD_PARAGRAPH_CACHE);
+	virtual ~TextLayout();
+
+	//the width of a single line of text, measured with TTF_SizeUTF8
+	int measure(TTF_Font*, const std::string& utf8);
+	//wraps the text at spaces to max_width (0 only breaks at '\n') and aligns the lines
+	const Paragraph& layout(TTF_Font*, const std::string& utf8, int max_width, TextAlign align=ALIGN_LEFT);
+
+	void clear();
+	unsigned int get_hits() const;
+	unsigned int get_misses() const;
+
+};
+
+TextLayout mainTextLayout;
+
+//IMPLEMENTATION
+TextLayout::TextLayout(size_t max_paragraphs){
+	this->max_paragraphs = max_paragraphs;
+}
+
+TextLayout::~TextLayout(){
+}
+
+std::string TextLayout::font_name(TTF_Font* font) const{
+
+	FontKey key;
+	if (FontCache::instance().get_key(font, key)) return key.path + ":" + std::to_string(key.size);
+	return std::to_string(reinterpret_cast<uintptr_t>(font));
+
+}
+
+int TextLayout::cached_width(TTF_Font* font, const std::string& name, const std::string& run){
+
+	std::string key = name + "\n" + run;
+	auto it = widths.find(key);
+	if (it != widths.end()) return it->second;
+
+	int w = 0, h = 0;
+	if (!run.empty()) TTF_SizeUTF8(font, run.c_str(), &w, &h);
+	widths[key] = w;
+	return w;
+
+}
+
+int TextLayout::measure(TTF_Font* font, const std::string& utf8){
+	if (font == nullptr) return 0;
+	return cached_width(font, font_name(font), utf8);
+}
+
+void TextLayout::add_line(TTF_Font* font, Paragraph& p, const std::string& text){
+
+	//measured as a whole, so kerning around the spaces is counted too
+	int w = 0, h = 0;
+	if (!text.empty()) TTF_SizeUTF8(font, text.c_str(), &w, &h);
+
+	p.lines.push_back(LayoutLine{text, 0, static_cast<int>(p.lines.size()) * TTF_FontLineSkip(font), w});
+
+}
+
+void TextLayout::break_word(TTF_Font* font, Paragraph& p, const std::string& word, int max_width, std::string& line, int& line_width){
+
+	line.clear();
+	size_t i = 0;
+	while (i < word.size()){
+
+		//one UTF-8 sequence, continuation bytes are 10xxxxxx
+		size_t end = i + 1;
+		while (end < word.size() && (static_cast<unsigned char>(word[end]) & 0xc0) == 0x80) end++;
+
+		std::string candidate = line + word.substr(i, end - i);
+		int w = 0, h = 0;
+		TTF_SizeUTF8(font, candidate.c_str(), &w, &h);
+
+		if (w > max_width && !line.empty()){
+			add_line(font, p, line);
+			line = word.substr(i, end - i);
+			TTF_SizeUTF8(font, line.c_str(), &line_width, &h);
+		}
+		else{
+			line = candidate;
+			line_width = w;
+		}
+		i = end;
+
+	}
+
+}
+
+const Paragraph& TextLayout::layout(TTF_Font* font, const std::string& utf8, int max_width, TextAlign align){
+
+	std::string name = font_name(font);
+	ParagraphKey key{std::hash<std::string>()(utf8), name, max_width, align};
+
+	auto it = paragraphs.find(key);
+	if (it != paragraphs.end() && it->second.text == utf8){
+		hits += 1;
+		return it->second;
+	}
+	misses += 1;
+
+	if (paragraphs.size() >= max_paragraphs) clear();
+
+	Paragraph& p = paragraphs[key];
+	p = Paragraph();
+	p.text = utf8;
+	if (font == nullptr) return p;
+
+	int space = cached_width(font, name, " ");
+
+	size_t start = 0;
+	while (start <= utf8.size()){
+
+		size_t end = utf8.find('\n', start);
+		if (end == std::string::npos) end = utf8.size();
+		std::string hard = utf8.substr(start, end - start);
+		start = end + 1;
+
+		if (max_width <= 0){
+			add_line(font, p, hard);
+			continue;
+		}
+
+		//greedy wrapping on the cached word widths, every line is measured exactly once it is done
+		std::string line;
+		int line_width = 0;
+		size_t word_start = 0;
+		while (word_start <= hard.size()){
+
+			size_t word_end = hard.find(' ', word_start);
+			if (word_end == std::string::npos) word_end = hard.size();
+			std::string word = hard.substr(word_start, word_end - word_start);
+			word_start = word_end + 1;
+			if (word.empty()) continue;
+
+			int w = cached_width(font, name, word);
+			if (!line.empty() && line_width + space + w <= max_width){
+				line += " " + word;
+				line_width += space + w;
+				continue;
+			}
+
+			if (!line.empty()) add_line(font, p, line);
+			if (w > max_width) break_word(font, p, word, max_width, line, line_width);
+			else{
+				line = word;
+				line_width = w;
+			}
+
+		}
+		add_line(font, p, line);
+
+	}
+
+	for (const LayoutLine& line : p.lines) p.width = std::max(p.width, line.width);
+	for (LayoutLine& line : p.lines){
+		if (align == ALIGN_CENTER) line.x = (p.width - line.width) / 2;
+		else if (align == ALIGN_RIGHT) line.x = p.width - line.width;
+	}
+	p.height = static_cast<int>(p.lines.size() - 1) * TTF_FontLineSkip(font) + TTF_FontHeight(font);
+
+	return p;
+
+}
+
+void TextLayout::clear(){
+	paragraphs.clear();
+	widths.clear();
+}
+
+unsigned int TextLayout::get_hits() const{
+	return hits;
+}
+
+unsigned int TextLayout::get_misses() const{
+	return misses;
+}
+
+#endif
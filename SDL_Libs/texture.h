@@ -18,23 +18,49 @@
 #include <iostream>
 #include <string>
 #include <cinttypes>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
 #include "window.h"
+#include "texture_cache.h"
+#include "async_loader.h"
 
 const SDL_BlendMode STANDARD_BLENDMODE = SDL_BLENDMODE_BLEND;
 const SDL_RendererFlip STANDARD_FLIPTYPE = SDL_FLIP_NONE;
 
+//when a texture decodes its image
+enum TextureLoad{
+					LOAD_NOW,
+					LOAD_ON_DRAW//only the size is read, the image is decoded on the first draw or prefetch
+				};
+
+class SpriteBatch;
+
 class Texture{
 
+	friend class SpriteBatch;
+	friend class AnimationClip;
+
 protected:
 
 	SDL_Texture* texture = nullptr;
 	SDL_Renderer* renderer = nullptr;
 	SDL_Surface* pixelSurface = nullptr;
-	Window* window;
-
-	//cliprect is the rectangle that specifies what part of the image is shown
+	Window* window = nullptr;
+	//set when texture and pixelSurface are borrowed from the TextureCache
+	CachedTexture* cached = nullptr;
+	//if the pixelSurface of the cached image is kept, see TextureResidency. Images of an ImageSource are always read on demand
+	TextureResidency residency = TextureCache::instance().get_default_residency();
+	bool holds_pixels = false;
+	//set while the image is decoded in the background
+	AsyncHandle pending;
+
+	//cliprect is the rectangle that specifies what part of the image is shown, only used while clipped is set
+	//animations switch it on every frame change, so it is kept in place and never freed
+	SDL_Rect cliprect = {0, 0, 0, 0};
+	bool clipped = false;
 	//renderrect specifies where the image will be rendered
-	SDL_Rect *cliprect = nullptr, *renderrect = nullptr;
+	SDL_Rect* renderrect = nullptr;
 	//blendmode, fliptype and center
 	SDL_BlendMode blendmode = STANDARD_BLENDMODE;
 	SDL_RendererFlip flipType = STANDARD_FLIPTYPE;
@@ -42,9 +68,41 @@ protected:
 
 	int width = -1, height = -1;
 	uint8_t alpha = 0xff;
+	uint8_t r=0xff, g=0xff, b=0xff; //for color modulation
 	double angle=0.0;
 	std::string filepath;
 
+	//streaming textures upload only the changed parts of pixelSurface
+	bool streaming = false;
+	std::vector<SDL_Rect> dirty_rects;
+	//draws smaller than the image use a downscaled level of the cached image
+	bool mipmapped = false;
+	//set while a LOAD_ON_DRAW texture has not decoded its image yet
+	bool deferred = false;
+
+	//gives the texture back to the cache or frees it
+	void free_texture();
+	//takes over an entry acquired from the cache with the own residency
+	void attach(CachedTexture*);
+	//leaves the cache with an own copy of pixelSurface and texture, so edits do not show up in textures sharing the image
+	void detach();
+	//cached textures are shared, so the own modulation is set right before drawing
+	void apply_modulation(SDL_Texture*) const;
+	//takes over the image once the AsyncLoader uploaded it
+	void adopt_pending();
+	//the texture to draw, the placeholder while still loading
+	SDL_Texture* drawn_texture() const;
+	//the smallest mip level still at least w x h, clip is pointed to the scaled cliprect if a level is picked
+	SDL_Texture* pick_mip(int w, int h, const SDL_Rect*& clip, SDL_Rect& scaled) const;
+
+	void free_rects();
+	//angle, rects, modulation and so on
+	void copy_state(const Texture&);
+	void copy_from(const Texture&);
+	void move_from(Texture&);
+	//gives target its own copy of texture and pixelSurface
+	void duplicate_data(Texture& target) const;
+
 public:
 
 	std::string path;
@@ -53,18 +111,26 @@ public:
 	//loads the texture preinitialized
 	Texture(const std::string&, Window* window_ptr);
 	Texture(const std::string&, Window* window_ptr, const SDL_Rect&, const SDL_Rect&);
+	Texture(const std::string&, Window* window_ptr, TextureLoad);
 
 	virtual ~Texture();
 
 	//loads the texture new from the path to SDL_renderer
 	void load(const std::string&, Window* window_ptr);
+	void load(const std::string&, Window* window_ptr, TextureLoad);
 	void reload();
+	//decodes a LOAD_ON_DRAW texture now, for example shortly before it comes on screen
+	void prefetch();
+	bool is_deferred() const;
 
 	int get_width() const;
 	int get_height() const;
 
 	//for independent loading
 	void load_image(const std::string&, bool reload = false);
+	//decodes the image on the loaders worker threads, a placeholder is drawn until it is uploaded
+	void load_async(const std::string&, Window* window_ptr, AsyncLoader& loader);
+	bool is_loaded() const;
 	//setting the two rects
 	void set_cliprect(const SDL_Rect&);
 	void set_renderrect(const SDL_Rect&);
@@ -85,8 +151,26 @@ public:
 	const double get_angle();
 	void rotation_config(const SDL_Point&, const SDL_RendererFlip f=STANDARD_FLIPTYPE);
 	
+	//the first call copies the image out of the cache, so editing only changes this texture. reload uploads the edits
 	uint32_t* get_pixels();
 	uint32_t get_pitch(); //width of the pixel line
+	//the surface behind get_pixels, for the format of the pixels
+	SDL_Surface* get_surface();
+
+	//where the pixels are kept, GPU_ONLY textures give back no pixels
+	void set_residency(TextureResidency);
+	TextureResidency get_residency() const;
+
+	//gives the texture its own streaming texture, after editing the pixels mark the changed parts as dirty
+	void enable_streaming();
+	bool is_streaming() const;
+	void mark_dirty(const SDL_Rect&);
+	//uploads the dirty parts, overlapping rects get merged first. Happens on draw automatically
+	void upload_dirty();
+
+	//downscaled copies for drawing smaller than the image, shared by all textures of the same cached image
+	void set_mipmaps(bool);
+	bool has_mipmaps() const;
 
 	void create_blank(int, int, SDL_TextureAccess acc = SDL_TEXTUREACCESS_TARGET);
 	void set_as_render_target(SDL_Renderer*);
@@ -96,10 +180,15 @@ public:
 	void draw() const;
 	void draw(int x, int y, int w=-1, int h=-1) const;
 
-	Texture& operator=(Texture&&);
-	Texture& operator=(Texture&);
+	//a copy of the texture with its own GPU data, without touching the filesystem
+	//a texture still loading with load_async gives a copy that gets the same image once it is uploaded
+	Texture clone() const;
+
+	//moving only hands over the SDL objects, copying shares the cached image
+	Texture& operator=(Texture&&) noexcept;
+	Texture& operator=(const Texture&);
 	Texture(const Texture&);
-	Texture(const Texture&&);
+	Texture(Texture&&) noexcept;
 
 };
 
@@ -123,16 +212,14 @@ Texture::Texture(const std::string& path, Window* window_ptr, const SDL_Rect& cr
 	set_renderrect(rr);
 }
 
-Texture::~Texture(){
-
-
+Texture::Texture(const std::string& path, Window* window_ptr, TextureLoad when){
+	load(path, window_ptr, when);
+}
 
-	if (texture != nullptr) SDL_DestroyTexture(texture);
-	if(pixelSurface != nullptr) SDL_FreeSurface(pixelSurface);
+Texture::~Texture(){
 
-	if (cliprect != nullptr) delete cliprect;
-	if (renderrect != nullptr) delete renderrect;
-	if(center != nullptr) delete center;
+	free_texture();
+	free_rects();
 
 }
 
@@ -144,6 +231,40 @@ void Texture::load(const std::string& path, Window* window_ptr){
 	load_image(path);
 }
 
+void Texture::load(const std::string& path, Window* window_ptr, TextureLoad when){
+
+	if (when == LOAD_NOW){
+		load(path, window_ptr);
+		return;
+	}
+
+	this->window = window_ptr;
+	free_texture();
+
+	filepath = path;
+	this->path = path;
+	if (window == nullptr) return;
+
+	//without a known size the texture could not be laid out, so it gets loaded right away
+	if (!TextureCache::instance().peek_size(path, window->renderer, width, height)){
+		load_image(path);
+		return;
+	}
+
+	deferred = true;
+
+}
+
+void Texture::prefetch(){
+	if (!deferred) return;
+	deferred = false;
+	load_image(filepath);
+}
+
+bool Texture::is_deferred() const{
+	return deferred;
+}
+
 int Texture::get_width() const {
 	return width;
 }
@@ -152,49 +273,168 @@ int Texture::get_height() const{
 	return height;
 }
 
+void Texture::free_texture(){
+
+	if (cached != nullptr){
+		if (holds_pixels) TextureCache::instance().unlock_pixels(cached);
+		TextureCache::instance().release(cached, residency);
+		cached = nullptr;
+	}
+	else{
+		if (texture != nullptr) SDL_DestroyTexture(texture);
+		if (pixelSurface != nullptr) SDL_FreeSurface(pixelSurface);
+	}
+
+	texture = nullptr;
+	pixelSurface = nullptr;
+	holds_pixels = false;
+	pending = nullptr;
+	streaming = false;
+	dirty_rects.clear();
+	deferred = false;
+
+}
+
 void Texture::load_image(const std::string& path, bool reload){
 
 
 	if (window == nullptr) return;
-	if (texture != nullptr) SDL_DestroyTexture(texture);
 
-	SDL_Surface* s;
+	if (reload){
 
-	if (!reload){
-		filepath = path;
-		if (pixelSurface != nullptr) SDL_FreeSurface(pixelSurface);
-		s = IMG_Load(path.c_str());
-		this->path = path;
-		if(s == nullptr) {
-			std::cout << "Image with path: " << path << " could not be loaded" << std::endl; 
-			exit(1);
-		}
+		//a texture still sharing the cached image has not been edited, get_pixels detaches it first
+		if (pixelSurface == nullptr || cached != nullptr) return;
 
-		if (window != nullptr){
-			pixelSurface = SDL_ConvertSurfaceFormat(s, SDL_GetWindowPixelFormat(window->window), 0);
+		if (streaming){
+			//streaming textures get updated in place instead of recreated
+			dirty_rects.clear();
+			SDL_UpdateTexture(texture, nullptr, pixelSurface->pixels, pixelSurface->pitch);
+		}
+		else{
+			if (texture != nullptr) SDL_DestroyTexture(texture);
+			texture = SDL_CreateTextureFromSurface(window->renderer, pixelSurface);
 		}
+		return;
+	}
 
+	free_texture();
 
-		width = s->w;
-		height = s->h;	
+	filepath = path;
+	this->path = path;
 
-		set_blendmode(blendmode);
-		set_alpha(alpha);
+	attach(TextureCache::instance().acquire(path, window, residency));
+
+}
 
+void Texture::attach(CachedTexture* entry){
+
+	cached = entry;
+	texture = cached->texture;
+	width = cached->width;
+	height = cached->height;
+
+	//the pointer is only kept while the pixels are locked, otherwise the cache may free them
+	//images of a source like an AssetPack are read from it again when get_pixels asks, so they are not copied up front
+	if (residency == CPU_AND_GPU && cached->source == nullptr){
+		pixelSurface = TextureCache::instance().lock_pixels(cached);
+		holds_pixels = true;
 	}
+	else pixelSurface = nullptr;
 
-	if (pixelSurface != nullptr){
-		texture = SDL_CreateTextureFromSurface(window->renderer, pixelSurface);
+	if (mipmapped) TextureCache::instance().build_mips(cached);
+
+}
+
+void Texture::detach(){
+
+	if (cached == nullptr || window == nullptr || residency == GPU_ONLY) return;
+
+	SDL_Surface* shared = holds_pixels ? pixelSurface : TextureCache::instance().lock_pixels(cached);
+	SDL_Surface* own = (shared != nullptr) ? SDL_DuplicateSurface(shared) : nullptr;
+	if (!holds_pixels) TextureCache::instance().unlock_pixels(cached);
+	if (own == nullptr) return;
+
+	free_texture();
+	pixelSurface = own;
+	texture = SDL_CreateTextureFromSurface(window->renderer, own);
+
+}
+
+void Texture::load_async(const std::string& path, Window* window_ptr, AsyncLoader& loader){
+
+	this->window = window_ptr;
+	if (window == nullptr) return;
+
+	free_texture();
+
+	filepath = path;
+	this->path = path;
+
+	pending = loader.request(path, window);
+	width = pending->width;
+	height = pending->height;
+
+	adopt_pending();
+
+}
+
+void Texture::adopt_pending(){
+
+	if (pending == nullptr) return;
+
+	int state = pending->state;
+	if (state == ASYNC_READY){
+		attach(TextureCache::instance().find(pending->path, pending->renderer, residency));
+		pending = nullptr;
 	}
-	else if(!reload){
-		texture = SDL_CreateTextureFromSurface(window->renderer, s);
+	else if (state == ASYNC_FAILED){
+		pending = nullptr;
 	}
 
-	if (!reload){
-		SDL_FreeSurface(s);
+}
+
+bool Texture::is_loaded() const{
+	return texture != nullptr && pending == nullptr;
+}
+
+SDL_Texture* Texture::drawn_texture() const{
+
+	if (deferred) const_cast<Texture*>(this)->prefetch();
+
+	if (!dirty_rects.empty()) const_cast<Texture*>(this)->upload_dirty();
+
+	if (pending != nullptr){
+		//checking if the loader finished since the last frame
+		const_cast<Texture*>(this)->adopt_pending();
+		if (pending != nullptr) return pending->placeholder->texture;
 	}
 
-	
+	//the cache may have evicted the image since the last draw
+	if (cached != nullptr) const_cast<Texture*>(this)->texture = TextureCache::instance().use(cached);
+
+	return texture;
+
+}
+
+SDL_Texture* Texture::pick_mip(int w, int h, const SDL_Rect*& clip, SDL_Rect& scaled) const{
+
+	if (!mipmapped || cached == nullptr || cached->mips.empty()) return texture;
+
+	int sw = (clip != nullptr) ? clip->w : width;
+	int sh = (clip != nullptr) ? clip->h : height;
+	w = std::abs(w);
+	h = std::abs(h);
+
+	size_t level = 0;
+	while (level < cached->mips.size() && (sw >> (level + 1)) >= w && (sh >> (level + 1)) >= h) level++;
+	if (level == 0) return texture;
+
+	if (clip != nullptr){
+		int shift = static_cast<int>(level);
+		scaled = SDL_Rect{clip->x >> shift, clip->y >> shift, std::max(clip->w >> shift, 1), std::max(clip->h >> shift, 1)};
+		clip = &scaled;
+	}
+	return cached->mips[level - 1];
 
 }
 
@@ -203,63 +443,87 @@ void Texture::reload(){
 }
 
 void Texture::set_cliprect(const SDL_Rect& cr){
-
-	if (cliprect != nullptr){
-		delete cliprect;
-	}
-	cliprect = new SDL_Rect{cr};
+	cliprect = cr;
+	clipped = true;
 }
 
 void Texture::set_renderrect(const SDL_Rect& rr){
 
-	if (renderrect != nullptr){
-		delete renderrect;
-	}
-	renderrect = new SDL_Rect{rr};
+	if (renderrect != nullptr) *renderrect = rr;
+	else renderrect = new SDL_Rect{rr};
 }
 
 void Texture::unset_cliprect(){
-	if (cliprect != nullptr) delete cliprect;
+	clipped = false;
 }
 
 void Texture::unset_renderrect(){
 	if (renderrect != nullptr) delete renderrect;
+	renderrect = nullptr;
 }
 
 void Texture::set_window(Window* window_ptr){
 	this->window = window_ptr;
-	load_image(this->filepath);
+	//blank textures have nothing to load
+	if (deferred) load(filepath, window_ptr, LOAD_ON_DRAW);
+	else if (!filepath.empty()) load_image(this->filepath);
 }
 
 Window const* Texture::get_window() const{
 	return window;
 }
 
+void Texture::apply_modulation(SDL_Texture* t) const{
+	SDL_SetTextureColorMod(t, r, g, b);
+	SDL_SetTextureBlendMode(t, blendmode);
+	SDL_SetTextureAlphaMod(t, alpha);
+}
+
 void Texture::draw() const {
-	if (window == nullptr || texture == nullptr) return;
-	SDL_RenderCopyEx(window->renderer, texture, cliprect, renderrect, angle, center, flipType);
+	if (window == nullptr) return;
+	SDL_Texture* t = drawn_texture();
+	if (t == nullptr) return;
+
+	const SDL_Rect* clip = (pending == nullptr && clipped) ? &cliprect : nullptr;
+	SDL_Rect scaled;
+	if (pending == nullptr && renderrect != nullptr) t = pick_mip(renderrect->w, renderrect->h, clip, scaled);
+
+	apply_modulation(t);
+	SDL_RenderCopyEx(window->renderer, t, clip, renderrect, angle, center, flipType);
 }
 
 void Texture::draw(int x, int y, int w, int h) const {
 
 
-	if (window == nullptr || texture == nullptr) return;
+	if (window == nullptr) return;
+	SDL_Texture* t = drawn_texture();
+	if (t == nullptr) return;
 	if( w == -1) w = width;
 	if (h == -1) h = height;
-	SDL_Rect r = {x, y, w, h};
-	SDL_RenderCopyEx(window->renderer, texture, cliprect, &r, angle, center, flipType);
+	SDL_Rect rr = {x, y, w, h};
+
+	const SDL_Rect* clip = (pending == nullptr && clipped) ? &cliprect : nullptr;
+	SDL_Rect scaled;
+	if (pending == nullptr) t = pick_mip(w, h, clip, scaled);
+
+	apply_modulation(t);
+	SDL_RenderCopyEx(window->renderer, t, clip, &rr, angle, center, flipType);
 
 }
 
 void Texture::modulate_color(const uint8_t r, const uint8_t g, const uint8_t b){
-	if(texture != nullptr){
+	this->r = r;
+	this->g = g;
+	this->b = b;
+	//cached textures are shared and may get evicted, they get the modulation on draw
+	if(texture != nullptr && cached == nullptr){
 		SDL_SetTextureColorMod(texture, r, g, b);
 	}
 }
 
 void Texture::set_blendmode(const SDL_BlendMode b){
 	this->blendmode = b;
-	if(this->texture != nullptr){
+	if(this->texture != nullptr && cached == nullptr){
 		SDL_SetTextureBlendMode(texture, blendmode);
 		SDL_SetTextureAlphaMod(texture, alpha);
 	}
@@ -271,7 +535,7 @@ const SDL_BlendMode Texture::get_blendmode() const{
 
 void Texture::set_alpha(const uint8_t a){
 	this->alpha = a;
-	if (this->texture != nullptr){
+	if (this->texture != nullptr && cached == nullptr){
 		SDL_SetTextureBlendMode(texture, blendmode);
 		SDL_SetTextureAlphaMod(texture, alpha);
 	}
@@ -297,24 +561,142 @@ void Texture::rotation_config(const SDL_Point& p, const SDL_RendererFlip f){
 }
 
 uint32_t* Texture::get_pixels(){
+	prefetch();
+	//the pixels are handed out for writing, so the shared cached image is never given away
+	detach();
 	if (pixelSurface == nullptr) return nullptr;
 	return static_cast<uint32_t*>(pixelSurface->pixels);
 }
 
 uint32_t Texture::get_pitch(){
 
+	get_pixels();
 	uint32_t back = 0;
 	if (pixelSurface != nullptr) back = pixelSurface->pitch >> 2;
 	return back;
 }
 
+SDL_Surface* Texture::get_surface(){
+	get_pixels();
+	return pixelSurface;
+}
+
+void Texture::enable_streaming(){
+
+	if (window == nullptr || streaming || get_pixels() == nullptr) return;
+
+	//get_pixels already gave the texture its own copy of the image
+	SDL_DestroyTexture(texture);
+
+	texture = SDL_CreateTexture(window->renderer, pixelSurface->format->format, SDL_TEXTUREACCESS_STREAMING, pixelSurface->w, pixelSurface->h);
+	SDL_UpdateTexture(texture, nullptr, pixelSurface->pixels, pixelSurface->pitch);
+
+	streaming = true;
+
+}
+
+void Texture::set_mipmaps(bool enabled){
+	mipmapped = enabled;
+	if (mipmapped && cached != nullptr) TextureCache::instance().build_mips(cached);
+}
+
+bool Texture::has_mipmaps() const{
+	return mipmapped;
+}
+
+bool Texture::is_streaming() const{
+	return streaming;
+}
+
+void Texture::mark_dirty(const SDL_Rect& rect){
+
+	if (!streaming) return;
+
+	//clipping to the image
+	int x0 = std::max(rect.x, 0), y0 = std::max(rect.y, 0);
+	int x1 = std::min(rect.x + rect.w, pixelSurface->w), y1 = std::min(rect.y + rect.h, pixelSurface->h);
+	if (x1 <= x0 || y1 <= y0) return;
+
+	dirty_rects.push_back(SDL_Rect{x0, y0, x1 - x0, y1 - y0});
+
+}
+
+void Texture::upload_dirty(){
+
+	if (!streaming || dirty_rects.empty()) return;
+
+	//merging rects that overlap or touch, until none are left to merge
+	bool merged = true;
+	while (merged){
+		merged = false;
+		for (unsigned int i = 0; i < dirty_rects.size() && !merged; i++){
+			for (unsigned int j = i + 1; j < dirty_rects.size(); j++){
+
+				SDL_Rect& a = dirty_rects[i];
+				const SDL_Rect& o = dirty_rects[j];
+				if (a.x > o.x + o.w || o.x > a.x + a.w || a.y > o.y + o.h || o.y > a.y + a.h) continue;
+
+				int x0 = std::min(a.x, o.x), y0 = std::min(a.y, o.y);
+				int x1 = std::max(a.x + a.w, o.x + o.w), y1 = std::max(a.y + a.h, o.y + o.h);
+				a = SDL_Rect{x0, y0, x1 - x0, y1 - y0};
+				dirty_rects.erase(dirty_rects.begin() + j);
+				merged = true;
+				break;
+
+			}
+		}
+	}
+
+	const uint8_t* pixels = static_cast<const uint8_t*>(pixelSurface->pixels);
+	int bpp = pixelSurface->format->BytesPerPixel;
+
+	for (const SDL_Rect& rect : dirty_rects){
+		const uint8_t* start = pixels + rect.y * pixelSurface->pitch + rect.x * bpp;
+		SDL_UpdateTexture(texture, &rect, start, pixelSurface->pitch);
+	}
+
+	dirty_rects.clear();
+
+}
+
+void Texture::set_residency(TextureResidency res){
+
+	if (res == residency) return;
+
+	if (cached != nullptr){
+
+		TextureCache::instance().change_residency(cached, residency, res);
+
+		if (res == CPU_AND_GPU && !holds_pixels && cached->source == nullptr){
+			pixelSurface = TextureCache::instance().lock_pixels(cached);
+			holds_pixels = true;
+		}
+		else if (res != CPU_AND_GPU && holds_pixels){
+			holds_pixels = false;
+			pixelSurface = nullptr;
+			TextureCache::instance().unlock_pixels(cached);
+		}
+
+	}
+
+	residency = res;
+
+}
+
+TextureResidency Texture::get_residency() const{
+	return residency;
+}
+
 void Texture::create_blank(int width, int height, SDL_TextureAccess access){
 
 	if(window == nullptr) return;
-	if (texture != nullptr) SDL_DestroyTexture(texture);
-	if (pixelSurface != nullptr) SDL_FreeSurface(pixelSurface);
+	free_texture();
 
 	texture = SDL_CreateTexture(window->renderer, SDL_PIXELFORMAT_RGBA8888, access, width, height);
+	this->width = width;
+	this->height = height;
+	filepath.clear();
+	path.clear();
 
 }
 
@@ -327,23 +709,168 @@ void Texture::unset_as_render_target(SDL_Renderer* r){
 	SDL_SetRenderTarget(r, nullptr);
 }
 
-Texture& Texture::operator=(Texture&& t){
+void Texture::free_rects(){
+
+	if (renderrect != nullptr) delete renderrect;
+	if (center != nullptr) delete center;
+
+	clipped = false;
+	renderrect = nullptr;
+	center = nullptr;
+
+}
+
+void Texture::copy_state(const Texture& other){
+
+	free_rects();
+	cliprect = other.cliprect;
+	clipped = other.clipped;
+	if (other.renderrect != nullptr) renderrect = new SDL_Rect{*(other.renderrect)};
+	if (other.center != nullptr) center = new SDL_Point{*(other.center)};
+
+	blendmode = other.blendmode;
+	flipType = other.flipType;
+	alpha = other.alpha;
+	r = other.r;
+	g = other.g;
+	b = other.b;
+	angle = other.angle;
+	residency = other.residency;
+	mipmapped = other.mipmapped;
+	deferred = other.deferred;
+
+	window = other.window;
+	filepath = other.filepath;
+	path = other.path;
+	width = other.width;
+	height = other.height;
+
+}
 
-	load(t.filepath, t.window);
+void Texture::copy_from(const Texture& other){
+
+	free_texture();
+	copy_state(other);
+
+	if (other.cached != nullptr){
+		//sharing the cached image, only the reference count changes
+		attach(TextureCache::instance().find(other.cached->key, other.cached->renderer, residency));
+	}
+	else if (other.pending != nullptr){
+		pending = other.pending;
+	}
+	else other.duplicate_data(*this);
+
+}
+
+void Texture::move_from(Texture& other){
+
+	texture = other.texture;
+	renderer = other.renderer;
+	pixelSurface = other.pixelSurface;
+	window = other.window;
+	cached = other.cached;
+	residency = other.residency;
+	holds_pixels = other.holds_pixels;
+	pending = std::move(other.pending);
+	streaming = other.streaming;
+	dirty_rects = std::move(other.dirty_rects);
+	mipmapped = other.mipmapped;
+	deferred = other.deferred;
+
+	cliprect = other.cliprect;
+	clipped = other.clipped;
+	renderrect = other.renderrect;
+	center = other.center;
+
+	blendmode = other.blendmode;
+	flipType = other.flipType;
+	width = other.width;
+	height = other.height;
+	alpha = other.alpha;
+	r = other.r;
+	g = other.g;
+	b = other.b;
+	angle = other.angle;
+	filepath = std::move(other.filepath);
+	path = std::move(other.path);
+
+	//other is empty now, its destructor frees nothing
+	other.texture = nullptr;
+	other.pixelSurface = nullptr;
+	other.cached = nullptr;
+	other.holds_pixels = false;
+	other.streaming = false;
+	other.deferred = false;
+	other.clipped = false;
+	other.renderrect = nullptr;
+	other.center = nullptr;
+	other.width = -1;
+	other.height = -1;
+
+}
+
+void Texture::duplicate_data(Texture& target) const{
+
+	if (window == nullptr || texture == nullptr) return;
+	SDL_Texture* source = (cached != nullptr) ? TextureCache::instance().use(cached) : texture;
+	if (source == nullptr) return;
+
+	if (pixelSurface != nullptr){
+		target.pixelSurface = SDL_DuplicateSurface(pixelSurface);
+		target.texture = SDL_CreateTextureFromSurface(window->renderer, target.pixelSurface);
+		return;
+	}
+
+	//render targets have no pixels on the CPU side, so the copy is made on the GPU
+	uint32_t format;
+	int access, w, h;
+	SDL_QueryTexture(source, &format, &access, &w, &h);
+
+	target.texture = SDL_CreateTexture(window->renderer, format, SDL_TEXTUREACCESS_TARGET, w, h);
+
+	SDL_Texture* old_target = SDL_GetRenderTarget(window->renderer);
+	SDL_SetRenderTarget(window->renderer, target.texture);
+	SDL_SetTextureBlendMode(source, SDL_BLENDMODE_NONE);
+	SDL_SetTextureColorMod(source, 0xff, 0xff, 0xff);
+	SDL_SetTextureAlphaMod(source, 0xff);
+	SDL_RenderCopy(window->renderer, source, nullptr, nullptr);
+	SDL_SetRenderTarget(window->renderer, old_target);
+
+}
+
+Texture Texture::clone() const{
+
+	Texture copy;
+	copy.copy_state(*this);
+	//there is nothing to duplicate yet, the copy waits for the same upload and takes the image from the cache like this one
+	if (pending != nullptr) copy.pending = pending;
+	else duplicate_data(copy);
+	return copy;
+
+}
+
+Texture& Texture::operator=(Texture&& t) noexcept{
+
+	if (this != &t){
+		free_texture();
+		free_rects();
+		move_from(t);
+	}
 	return (*this);
 }
 
-Texture& Texture::operator=(Texture& t){
+Texture& Texture::operator=(const Texture& t){
 
-	load(t.filepath, t.window);
+	if (this != &t) copy_from(t);
 	return (*this);
 }
 
 Texture::Texture(const Texture& other){
-	load(other.filepath, other.window);
+	copy_from(other);
 }
-Texture::Texture(const Texture&& other){
-	load(other.filepath, other.window);
+Texture::Texture(Texture&& other) noexcept{
+	move_from(other);
 }
 
-#endif
\ No newline at end of file
+#endif
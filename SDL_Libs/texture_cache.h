@@ -0,0 +1,603 @@
+#ifndef __TEXTURE_CACHE__
+#define __TEXTURE_CACHE__
+
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#include <SDL2/SDL_mixer.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <list>
+#include <vector>
+#include <algorithm>
+#include "window.h"
+#include "image_functions.h"
+
+/*
+*
+*	Process wide cache for decoded images. Every texture is stored once per (key, renderer),
+*	so loading the same path a second time only costs a hash lookup.
+*	Entries are refcounted, the SDL objects get freed when the last user releases them.
+*	Images loaded from a file only keep their pixelSurface while a user needs it (see TextureResidency).
+*	With a memory budget, images from a file that were not drawn for the longest time get evicted
+*	and are loaded again on their next draw.
+*
+*	Example usage:
+*		CachedTexture* entry = TextureCache::instance().acquire("PATH.png", &window);
+*		//drawing entry->texture
+*		TextureCache::instance().release(entry);
+*
+*/
+
+//where the pixels of a texture are kept
+enum TextureResidency{
+					GPU_ONLY,//the pixelSurface is freed right after the upload
+					CPU_AND_GPU,//the pixelSurface stays for the whole lifetime
+					CPU_LAZY//the pixelSurface is decoded again when the pixels are asked for
+				};
+
+const int RESIDENCY_COUNT = 3;
+
+//bytes held by all cached textures, grouped by the most demanding residency of their users
+struct TextureMemoryReport{
+	unsigned int textures[RESIDENCY_COUNT];
+	size_t gpu_bytes[RESIDENCY_COUNT];
+	size_t cpu_bytes[RESIDENCY_COUNT];
+};
+
+//somewhere images come from besides single image files, for example an AssetPack
+class ImageSource{
+
+public:
+
+	virtual bool contains(const std::string& key) const = 0;
+	//creates the texture without going through an SDL_Surface, if possible
+	virtual SDL_Texture* create_texture(const std::string& key, SDL_Renderer* r, int& w, int& h, uint32_t& format) = 0;
+	//gives back a new surface in the given format, the caller frees it
+	virtual SDL_Surface* load_surface(const std::string& key, uint32_t format) = 0;
+	//the size without loading the image, false if the source does not know it
+	virtual bool get_size(const std::string&, int&, int&) const{ return false; }
+	virtual ~ImageSource(){}
+
+};
+
+struct CachedTexture{
+
+	std::string key;//the path, or any other unique name of the image
+	SDL_Renderer* renderer = nullptr;
+
+	SDL_Texture* texture = nullptr;
+	SDL_Surface* pixelSurface = nullptr;//shared between all users of the entry
+
+	int width = -1, height = -1;
+	uint32_t format = SDL_PIXELFORMAT_UNKNOWN;//format of pixelSurface, needed when decoding again
+	bool from_file = false;//only images from a file can drop their pixelSurface
+	ImageSource* source = nullptr;//where the file lies, nullptr for image files on disk
+
+	unsigned int references = 0;
+	unsigned int holders[RESIDENCY_COUNT] = {0, 0, 0};
+	unsigned int pixel_users = 0;//users currently holding pixelSurface
+
+	std::vector<SDL_Texture*> mips;//mips[i] is the image at 1/2^(i+1) size, built on request
+	bool wants_mips = false;//built again after an eviction
+
+	size_t bytes = 0;//GPU and CPU memory of the entry, as counted in the budget
+	std::list<CachedTexture*>::iterator lru_position;//the front of the list was drawn last
+
+
+};
+
+struct TextureKey{
+
+	std::string key;
+	SDL_Renderer* renderer;
+
+	bool operator==(const TextureKey& other) const{
+		return renderer == other.renderer && key == other.key;
+	}
+
+};
+
+struct TextureKeyHash{
+
+	size_t operator()(const TextureKey& k) const{
+		size_t h = std::hash<std::string>()(k.key);
+		return h ^ (std::hash<SDL_Renderer*>()(k.renderer) + 0x9e3779b9 + (h << 6) + (h >> 2));
+	}
+
+};
+
+class TextureCache{
+
+protected:
+
+	std::unordered_map<TextureKey, CachedTexture*, TextureKeyHash> entries;
+
+	unsigned int hits = 0, misses = 0;
+	TextureResidency default_residency = CPU_AND_GPU;
+	std::vector<ImageSource*> sources;//searched before the disk
+
+	std::list<CachedTexture*> lru;
+	size_t budget = 0, used_bytes = 0;//a budget of 0 is unlimited
+	unsigned int evictions = 0, reloads = 0;
+	unsigned int eviction_holds = 0;
+
+	TextureCache();
+
+	//frees the pixelSurface if nobody needs it anymore
+	void trim(CachedTexture*);
+	//counts the bytes of the entry again after its texture or surface changed
+	void account(CachedTexture*);
+	//evicts the least recently drawn images until the budget fits, keep is never evicted
+	void enforce_budget(CachedTexture* keep=nullptr);
+	void evict(CachedTexture*);
+	void reload(CachedTexture*);
+
+public:
+
+	static TextureCache& instance();
+
+	virtual ~TextureCache();
+
+	//gives back the entry for the image at path, decoding and uploading it only if it is not cached yet
+	CachedTexture* acquire(const std::string& path, Window* window_ptr, TextureResidency res=CPU_AND_GPU);
+	//the size of the image at path, from the cache, a mounted source or the PNG header. False if it is unknown without decoding
+	bool peek_size(const std::string& path, SDL_Renderer* r, int& w, int& h);
+	//gives back the entry if it exists (adding a reference), nullptr otherwise
+	CachedTexture* find(const std::string& key, SDL_Renderer* r, TextureResidency res=CPU_AND_GPU);
+	//stores an already created texture, the cache takes ownership of texture and surface
+	CachedTexture* insert(const std::string& key, SDL_Renderer* r, SDL_Texture* t, SDL_Surface* s, int w, int h, TextureResidency res=CPU_AND_GPU, bool from_file=false);
+	//drops one reference, the entry is freed when nobody uses it anymore
+	void release(CachedTexture*, TextureResidency res=CPU_AND_GPU);
+	//moves a user to another residency
+	void change_residency(CachedTexture*, TextureResidency from, TextureResidency to);
+
+	//gives back the pixelSurface, decoding it again if it was dropped. Every lock needs an unlock
+	SDL_Surface* lock_pixels(CachedTexture*);
+	void unlock_pixels(CachedTexture*);
+
+	//builds the half size levels of the entry down to 1 pixel, once for all users
+	bool build_mips(CachedTexture*);
+
+	//marks the entry as drawn and gives back its texture, loading it again if it was evicted
+	SDL_Texture* use(CachedTexture*);
+
+	//bytes of all cached textures that may stay loaded, 0 turns the budget off
+	void set_budget(size_t bytes);
+	size_t get_budget() const;
+	size_t get_used_bytes() const;
+	unsigned int get_evictions() const;
+	unsigned int get_reloads() const;
+	//while held nothing gets evicted, for code keeping SDL_Texture pointers for a while (like SpriteBatch)
+	void hold_evictions();
+	void release_evictions();
+
+	//images found in a mounted source are loaded from there instead of the disk
+	void mount(ImageSource*);
+	void unmount(ImageSource*);
+
+	void set_default_residency(TextureResidency);
+	TextureResidency get_default_residency() const;
+	TextureMemoryReport memory_report() const;
+	void print_memory_report(std::ostream& out=std::cout) const;
+
+	size_t size() const;
+	unsigned int get_hits() const;
+	unsigned int get_misses() const;
+
+	TextureCache(const TextureCache&) = delete;
+	TextureCache& operator=(const TextureCache&) = delete;
+
+};
+
+TextureCache::TextureCache(){
+}
+
+TextureCache& TextureCache::instance(){
+	static TextureCache cache;
+	return cache;
+}
+
+TextureCache::~TextureCache(){
+
+	//the renderers are most likely gone at this point, so only the bookkeeping is freed
+	for (auto& e : entries) delete e.second;
+
+}
+
+CachedTexture* TextureCache::acquire(const std::string& path, Window* window_ptr, TextureResidency res){
+
+	if (window_ptr == nullptr) return nullptr;
+
+	CachedTexture* entry = find(path, window_ptr->renderer, res);
+	if (entry != nullptr) return entry;
+
+	for (ImageSource* source : sources){
+
+		if (!source->contains(path)) continue;
+
+		int w = 0, h = 0;
+		uint32_t format = SDL_PIXELFORMAT_UNKNOWN;
+		SDL_Texture* t = source->create_texture(path, window_ptr->renderer, w, h, format);
+
+		entry = insert(path, window_ptr->renderer, t, nullptr, w, h, res, true);
+		entry->source = source;
+		entry->format = format;
+		account(entry);
+		return entry;
+
+	}
+
+	SDL_Surface* s = IMG_Load(path.c_str());
+	if(s == nullptr) {
+		std::cout << "Image with path: " << path << " could not be loaded" << std::endl;
+		exit(1);
+	}
+
+	SDL_Surface* converted = SDL_ConvertSurfaceFormat(s, SDL_GetWindowPixelFormat(window_ptr->window), 0);
+	SDL_Texture* t = SDL_CreateTextureFromSurface(window_ptr->renderer, converted != nullptr ? converted : s);
+
+	int w = s->w, h = s->h;
+	SDL_FreeSurface(s);
+
+	entry = insert(path, window_ptr->renderer, t, converted, w, h, res, true);
+	entry->format = SDL_GetWindowPixelFormat(window_ptr->window);
+	//a CPU_AND_GPU user locks the pixels right away, for the others they can go
+	if (res != CPU_AND_GPU) trim(entry);
+	account(entry);
+	return entry;
+
+}
+
+bool TextureCache::peek_size(const std::string& path, SDL_Renderer* r, int& w, int& h){
+
+	auto it = entries.find(TextureKey{path, r});
+	if (it != entries.end()){
+		w = it->second->width;
+		h = it->second->height;
+		return true;
+	}
+
+	for (ImageSource* source : sources){
+		if (source->contains(path)) return source->get_size(path, w, h);
+	}
+
+	return read_png_size(path, w, h);
+
+}
+
+CachedTexture* TextureCache::find(const std::string& key, SDL_Renderer* r, TextureResidency res){
+
+	auto it = entries.find(TextureKey{key, r});
+	if (it == entries.end()){
+		misses += 1;
+		return nullptr;
+	}
+
+	hits += 1;
+	it->second->references += 1;
+	it->second->holders[res] += 1;
+	return it->second;
+
+}
+
+CachedTexture* TextureCache::insert(const std::string& key, SDL_Renderer* r, SDL_Texture* t, SDL_Surface* s, int w, int h, TextureResidency res, bool from_file){
+
+	CachedTexture* entry = new CachedTexture;
+	entry->key = key;
+	entry->renderer = r;
+	entry->texture = t;
+	entry->pixelSurface = s;
+	entry->width = w;
+	entry->height = h;
+	entry->from_file = from_file;
+	if (s != nullptr) entry->format = s->format->format;
+	entry->references = 1;
+	entry->holders[res] = 1;
+
+	entries[TextureKey{key, r}] = entry;
+	lru.push_front(entry);
+	entry->lru_position = lru.begin();
+	account(entry);
+	enforce_budget(entry);
+	return entry;
+
+}
+
+void TextureCache::release(CachedTexture* entry, TextureResidency res){
+
+	if (entry == nullptr) return;
+	if (entry->holders[res] > 0) entry->holders[res] -= 1;
+	if (entry->references > 1){
+		entry->references -= 1;
+		trim(entry);
+		return;
+	}
+
+	entries.erase(TextureKey{entry->key, entry->renderer});
+	lru.erase(entry->lru_position);
+	used_bytes -= entry->bytes;
+
+	if (entry->texture != nullptr) SDL_DestroyTexture(entry->texture);
+	for (SDL_Texture* mip : entry->mips) SDL_DestroyTexture(mip);
+	if (entry->pixelSurface != nullptr) SDL_FreeSurface(entry->pixelSurface);
+	delete entry;
+
+}
+
+void TextureCache::change_residency(CachedTexture* entry, TextureResidency from, TextureResidency to){
+
+	if (entry == nullptr) return;
+	if (entry->holders[from] > 0) entry->holders[from] -= 1;
+	entry->holders[to] += 1;
+
+}
+
+void TextureCache::trim(CachedTexture* entry){
+
+	if (!entry->from_file || entry->pixel_users > 0 || entry->pixelSurface == nullptr) return;
+
+	SDL_FreeSurface(entry->pixelSurface);
+	entry->pixelSurface = nullptr;
+	account(entry);
+
+}
+
+SDL_Surface* TextureCache::lock_pixels(CachedTexture* entry){
+
+	if (entry == nullptr) return nullptr;
+
+	if (entry->pixelSurface == nullptr && entry->source != nullptr){
+		entry->pixelSurface = entry->source->load_surface(entry->key, entry->format);
+	}
+	else if (entry->pixelSurface == nullptr && entry->from_file){
+
+		SDL_Surface* s = IMG_Load(entry->key.c_str());
+		if (s == nullptr) {
+			std::cout << "Image with path: " << entry->key << " could not be loaded" << std::endl;
+			return nullptr;
+		}
+		entry->pixelSurface = SDL_ConvertSurfaceFormat(s, entry->format, 0);
+		SDL_FreeSurface(s);
+
+	}
+
+	account(entry);
+	entry->pixel_users += 1;
+	return entry->pixelSurface;
+
+}
+
+void TextureCache::unlock_pixels(CachedTexture* entry){
+
+	if (entry == nullptr) return;
+	if (entry->pixel_users > 0) entry->pixel_users -= 1;
+	trim(entry);
+
+}
+
+bool TextureCache::build_mips(CachedTexture* entry){
+
+	if (entry == nullptr) return false;
+	entry->wants_mips = true;
+	if (!entry->mips.empty() || entry->texture == nullptr || (entry->width <= 1 && entry->height <= 1)) return true;
+
+	SDL_Surface* level = lock_pixels(entry);
+	if (level == nullptr){
+		unlock_pixels(entry);
+		return false;
+	}
+
+	//every level is filtered from the one before, not from the full image
+	while (level->w > 1 || level->h > 1){
+
+		SDL_Surface* half = halve_surface(level);
+		if (level != entry->pixelSurface) SDL_FreeSurface(level);
+		level = half;
+		if (level == nullptr) break;
+
+		entry->mips.push_back(SDL_CreateTextureFromSurface(entry->renderer, level));
+
+	}
+	if (level != nullptr && level != entry->pixelSurface) SDL_FreeSurface(level);
+
+	unlock_pixels(entry);
+	account(entry);
+	enforce_budget(entry);
+	return !entry->mips.empty();
+
+}
+
+SDL_Texture* TextureCache::use(CachedTexture* entry){
+
+	if (entry == nullptr) return nullptr;
+
+	lru.splice(lru.begin(), lru, entry->lru_position);
+	if (entry->texture == nullptr && entry->from_file) reload(entry);
+	return entry->texture;
+
+}
+
+void TextureCache::account(CachedTexture* entry){
+
+	size_t bytes = 0;
+
+	if (entry->texture != nullptr){
+		size_t bpp = (entry->format != SDL_PIXELFORMAT_UNKNOWN) ? SDL_BYTESPERPIXEL(entry->format) : 4;
+		bytes += static_cast<size_t>(entry->width) * entry->height * bpp;
+		for (size_t i = 0; i < entry->mips.size(); i++){
+			size_t w = std::max(entry->width >> (i + 1), 1), h = std::max(entry->height >> (i + 1), 1);
+			bytes += w * h * bpp;
+		}
+	}
+	if (entry->pixelSurface != nullptr){
+		bytes += static_cast<size_t>(entry->pixelSurface->pitch) * entry->pixelSurface->h;
+	}
+
+	used_bytes = used_bytes - entry->bytes + bytes;
+	entry->bytes = bytes;
+
+}
+
+void TextureCache::enforce_budget(CachedTexture* keep){
+
+	if (budget == 0 || eviction_holds > 0) return;
+
+	//only images from a file can come back, everything else stays
+	auto it = lru.end();
+	while (used_bytes > budget && it != lru.begin()){
+		--it;
+		CachedTexture* entry = *it;
+		if (entry != keep && entry->from_file && entry->texture != nullptr) evict(entry);
+	}
+
+}
+
+void TextureCache::evict(CachedTexture* entry){
+
+	SDL_DestroyTexture(entry->texture);
+	for (SDL_Texture* mip : entry->mips) SDL_DestroyTexture(mip);
+	entry->texture = nullptr;
+	entry->mips.clear();
+
+	evictions += 1;
+	trim(entry);
+	account(entry);
+
+}
+
+void TextureCache::reload(CachedTexture* entry){
+
+	if (entry->pixelSurface == nullptr && entry->source != nullptr){
+		int w = 0, h = 0;
+		uint32_t format = SDL_PIXELFORMAT_UNKNOWN;
+		entry->texture = entry->source->create_texture(entry->key, entry->renderer, w, h, format);
+	}
+	else{
+		SDL_Surface* s = lock_pixels(entry);
+		if (s != nullptr) entry->texture = SDL_CreateTextureFromSurface(entry->renderer, s);
+		unlock_pixels(entry);
+	}
+
+	if (entry->texture == nullptr) return;
+
+	reloads += 1;
+	if (entry->wants_mips) build_mips(entry);
+	account(entry);
+	enforce_budget(entry);
+
+}
+
+void TextureCache::mount(ImageSource* source){
+	if (std::find(sources.begin(), sources.end(), source) == sources.end()) sources.push_back(source);
+}
+
+void TextureCache::unmount(ImageSource* source){
+	sources.erase(std::remove(sources.begin(), sources.end(), source), sources.end());
+}
+
+void TextureCache::set_budget(size_t bytes){
+	budget = bytes;
+	enforce_budget();
+}
+
+size_t TextureCache::get_budget() const{
+	return budget;
+}
+
+size_t TextureCache::get_used_bytes() const{
+	return used_bytes;
+}
+
+unsigned int TextureCache::get_evictions() const{
+	return evictions;
+}
+
+unsigned int TextureCache::get_reloads() const{
+	return reloads;
+}
+
+void TextureCache::hold_evictions(){
+	eviction_holds += 1;
+}
+
+void TextureCache::release_evictions(){
+	if (eviction_holds > 0) eviction_holds -= 1;
+	enforce_budget();
+}
+
+void TextureCache::set_default_residency(TextureResidency res){
+	default_residency = res;
+}
+
+TextureResidency TextureCache::get_default_residency() const{
+	return default_residency;
+}
+
+TextureMemoryReport TextureCache::memory_report() const{
+
+	TextureMemoryReport report;
+	for (int i = 0; i < RESIDENCY_COUNT; i++){
+		report.textures[i] = 0;
+		report.gpu_bytes[i] = 0;
+		report.cpu_bytes[i] = 0;
+	}
+
+	for (auto& e : entries){
+
+		const CachedTexture* entry = e.second;
+
+		int res = GPU_ONLY;
+		if (entry->holders[CPU_AND_GPU] > 0) res = CPU_AND_GPU;
+		else if (entry->holders[CPU_LAZY] > 0) res = CPU_LAZY;
+
+		size_t cpu = 0;
+		if (entry->pixelSurface != nullptr) cpu = static_cast<size_t>(entry->pixelSurface->pitch) * entry->pixelSurface->h;
+
+		report.textures[res] += 1;
+		report.gpu_bytes[res] += entry->bytes - cpu;
+		report.cpu_bytes[res] += cpu;
+
+	}
+
+	return report;
+
+}
+
+void TextureCache::print_memory_report(std::ostream& out) const{
+
+	const char* names[RESIDENCY_COUNT] = {"GPU_ONLY", "CPU_AND_GPU", "CPU_LAZY"};
+	TextureMemoryReport report = memory_report();
+
+	for (int i = 0; i < RESIDENCY_COUNT; i++){
+		out << names[i] << ": " << report.textures[i] << " textures, " << report.gpu_bytes[i] << " bytes GPU, " << report.cpu_bytes[i] << " bytes CPU" << std::endl;
+	}
+	out << "budget: " << used_bytes << " of " << budget << " bytes used, " << evictions << " evictions, " << reloads << " reloads" << std::endl;
+
+}
+
+size_t TextureCache::size() const{
+	return entries.size();
+}
+
+unsigned int TextureCache::get_hits() const{
+	return hits;
+}
+
+unsigned int TextureCache::get_misses() const{
+	return misses;
+}
+
+#endif
@@ -3,16 +3,32 @@
 
 
 #include "SDL_Libs/animation.h"
+#include "SDL_Libs/animation_clip.h"
+#include "SDL_Libs/animation_system.h"
+#include "SDL_Libs/asset_pack.h"
+#include "SDL_Libs/async_loader.h"
+#include "SDL_Libs/atlas.h"
 #include "SDL_Libs/camera.h"
+#include "SDL_Libs/collision_tree.h"
 #include "SDL_Libs/controller.h"
 #include "SDL_Libs/drawcircle.h"
 #include "SDL_Libs/font.h"
+#include "SDL_Libs/fontcache.h"
+#include "SDL_Libs/glyphatlas.h"
 #include "SDL_Libs/gameobject.h"
 #include "SDL_Libs/hitbox.h"
+#include "SDL_Libs/hitbox_batch.h"
 #include "SDL_Libs/image_functions.h"
+#include "SDL_Libs/layer.h"
+#include "SDL_Libs/pixelops.h"
 #include "SDL_Libs/texture.h"
+#include "SDL_Libs/textlayout.h"
+#include "SDL_Libs/texture_cache.h"
 #include "SDL_Libs/timer.h"
 #include "SDL_Libs/recording.h"
+#include "SDL_Libs/sdffont.h"
+#include "SDL_Libs/spritebatch.h"
+#include "SDL_Libs/spatial_hash.h"
 #include "SDL_Libs/window.h"
 
 
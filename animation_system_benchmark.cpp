@@ -0,0 +1,104 @@
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include "SDL_Libs/animation_system.h"
+
+/*
+*
+*	Compares advancing many playheads one AnimationPlayer at a time against the AnimationSystem, single and multi threaded.
+*	Only the update is timed. The clips are loaded without a window, so they have their frame table but no textures.
+*	Usage: animation_system_benchmark [PLAYHEADS] [FRAMES]
+*
+*/
+
+const int CLIP_COUNT = 8;
+const int CLIP_FRAMES = 6;
+const uint32_t FRAME_DT = 16;//milliseconds, about 60 frames per second
+
+static double now_ms(){
+	return SDL_GetPerformanceCounter() * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static void report(const char* name, double ms, int frames, size_t changed){
+	std::cout << name << ": " << ms / frames << " ms per update, " << changed / frames << " frame changes per update" << std::endl;
+}
+
+int main(int argc, char** argv){
+
+	int playheads = (argc > 1) ? std::atoi(argv[1]) : 100000;
+	int frames = (argc > 2) ? std::atoi(argv[2]) : 600;
+
+	//clips with different frame times, so not every playhead changes in the same update
+	std::vector<AnimationClip*> clips;
+	for (int i = 0; i < CLIP_COUNT; i++){
+		std::vector<std::string> paths;
+		for (int f = 0; f < CLIP_FRAMES; f++) paths.push_back("frame" + std::to_string(f) + ".png");
+		clips.push_back(new AnimationClip(nullptr, paths, STANDARD_CLIPRECTS, {static_cast<unsigned int>(40 + 10 * i)}));
+	}
+
+	std::mt19937 rng(1);
+	std::vector<const AnimationClip*> picked;
+	std::vector<uint8_t> picked_flags;
+	for (int i = 0; i < playheads; i++){
+		picked.push_back(clips[rng() % CLIP_COUNT]);
+		//every eighth one plays once and stops
+		picked_flags.push_back((rng() % 8 == 0) ? PLAYER_RUNNING : (PLAYER_RUNNING | PLAYER_LOOP));
+	}
+
+	std::cout << playheads << " playheads, " << frames << " updates of " << FRAME_DT << " ms" << std::endl;
+
+	std::vector<AnimationPlayer> players;
+	players.reserve(picked.size());
+	for (size_t i = 0; i < picked.size(); i++) players.push_back(AnimationPlayer(picked[i], picked_flags[i]));
+
+	size_t changed = 0;
+	double start = now_ms();
+	for (int f = 0; f < frames; f++){
+		for (AnimationPlayer& p : players) changed += p.update(FRAME_DT) ? 1 : 0;
+	}
+	report("AnimationPlayer one by one", now_ms() - start, frames, changed);
+
+	unsigned int cores = std::thread::hardware_concurrency();
+	std::vector<unsigned int> thread_counts = {1};
+	if (cores > 1) thread_counts.push_back(cores);
+
+	int mismatches = 0;
+	for (unsigned int threads : thread_counts){
+
+		AnimationSystem system(threads);
+		for (size_t i = 0; i < picked.size(); i++) system.add(picked[i], picked_flags[i]);
+
+		changed = 0;
+		start = now_ms();
+		for (int f = 0; f < frames; f++) changed += system.update(FRAME_DT);
+		double ms = now_ms() - start;
+
+		std::string name = "AnimationSystem, " + std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+		report(name.c_str(), ms, frames, changed);
+
+		//both ways have to end on the same frames
+		for (size_t i = 0; i < players.size(); i++){
+			if (system.get_frame(static_cast<uint32_t>(i)) != players[i].frame) mismatches++;
+		}
+
+	}
+
+	for (AnimationClip* c : clips) delete c;
+
+	if (mismatches != 0){
+		std::cout << mismatches << " playheads ended on another frame than their AnimationPlayer" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,127 @@
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include "SDL_Libs/texture.h"
+#include "SDL_Libs/asset_pack.h"
+
+/*
+*
+*	Compares the startup cost of loading images one by one as PNGs against loading them out of an AssetPack.
+*	Usage: asset_pack_benchmark [image1.png image2.png ...]
+*	Without images it writes BENCH_IMAGES noisy PNGs itself. The files were just written or read,
+*	so the operating system has them cached, for a really cold start drop the file cache before each run.
+*	SDL_VIDEODRIVER=dummy runs it without a display.
+*
+*/
+
+const int BENCH_IMAGES = 200;
+const int BENCH_IMAGE_SIZE = 256;
+const int BENCH_ROUNDS = 5;
+const char BENCH_PACK[] = "asset_pack_benchmark.pack";
+
+static double now_ms(){
+	return SDL_GetPerformanceCounter() * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+//noise, so decoding the PNG costs about as much as with real art
+static std::string make_image(int i, std::mt19937& rng){
+
+	SDL_Surface* s = SDL_CreateRGBSurfaceWithFormat(0, BENCH_IMAGE_SIZE, BENCH_IMAGE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+	uint32_t* pixels = static_cast<uint32_t*>(s->pixels);
+	for (int y = 0; y < s->h; y++){
+		for (int x = 0; x < s->w; x++) pixels[y * (s->pitch / 4) + x] = rng() | 0xff000000u;
+	}
+
+	std::string path = "asset_pack_benchmark_" + std::to_string(i) + ".png";
+	IMG_SavePNG(s, path.c_str());
+	SDL_FreeSurface(s);
+	return path;
+
+}
+
+//loads every image as a Texture and frees them again, gives back the milliseconds it took
+static double load_all(const std::vector<std::string>& paths, Window& window){
+
+	double start = now_ms();
+	{
+		std::vector<Texture> textures;
+		textures.reserve(paths.size());
+		for (const std::string& p : paths) textures.push_back(Texture(p, &window));
+	}
+	return now_ms() - start;
+
+}
+
+int main(int argc, char** argv){
+
+	SDL_Init(SDL_INIT_VIDEO);
+	IMG_Init(IMG_INIT_PNG);
+
+	std::vector<std::string> paths;
+	bool generated = (argc < 2);
+	std::mt19937 rng(1);
+	if (generated){
+		for (int i = 0; i < BENCH_IMAGES; i++) paths.push_back(make_image(i, rng));
+	}
+	else{
+		for (int i = 1; i < argc; i++) paths.push_back(argv[i]);
+	}
+
+	{
+
+		Window window("asset_pack_benchmark", 0, 0, 640, 480, SDL_WINDOW_HIDDEN);
+		if (window.renderer == nullptr){
+			std::cout << "No renderer: " << SDL_GetError() << std::endl;
+			return 1;
+		}
+
+		//packed in the format of the window, like asset_packer -f would
+		if (!AssetPack::write(BENCH_PACK, paths, SDL_GetWindowPixelFormat(window.window))) return 1;
+
+		double png_total = 0, pack_total = 0, png_best = 1e300, pack_best = 1e300;
+		for (int round = 0; round < BENCH_ROUNDS; round++){
+
+			double png = load_all(paths, window);
+
+			double start = now_ms();
+			AssetPack pack(BENCH_PACK);
+			TextureCache::instance().mount(&pack);
+			double opened = now_ms() - start;
+			double packed = opened + load_all(paths, window);
+			TextureCache::instance().unmount(&pack);
+
+			png_total += png;
+			pack_total += packed;
+			png_best = std::min(png_best, png);
+			pack_best = std::min(pack_best, packed);
+
+		}
+
+		std::cout << paths.size() << " images, " << BENCH_ROUNDS << " rounds" << std::endl;
+		std::cout << "PNG files: " << png_total / BENCH_ROUNDS << " ms average, " << png_best << " ms best" << std::endl;
+		std::cout << "AssetPack: " << pack_total / BENCH_ROUNDS << " ms average, " << pack_best << " ms best (open and mount included)" << std::endl;
+
+	}
+
+	std::remove(BENCH_PACK);
+	if (generated){
+		for (const std::string& p : paths) std::remove(p.c_str());
+	}
+
+	IMG_Quit();
+	SDL_Quit();
+
+	return 0;
+}
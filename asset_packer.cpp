@@ -0,0 +1,72 @@
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SDL_Libs/asset_pack.h"
+
+/*
+*
+*	Offline tool writing an AssetPack.
+*	Usage: asset_packer [-f FORMAT] out.pack image1.png image2.png ...
+*	FORMAT is the pixel format of the window the pack is used with, ARGB8888 if not given.
+*
+*/
+
+struct FormatName{
+	const char* name;
+	uint32_t format;
+};
+
+const FormatName FORMAT_NAMES[] = {
+	{"ARGB8888", SDL_PIXELFORMAT_ARGB8888},
+	{"RGBA8888", SDL_PIXELFORMAT_RGBA8888},
+	{"ABGR8888", SDL_PIXELFORMAT_ABGR8888},
+	{"BGRA8888", SDL_PIXELFORMAT_BGRA8888},
+	{"RGB888", SDL_PIXELFORMAT_RGB888},
+	{"BGR888", SDL_PIXELFORMAT_BGR888}
+};
+
+int main(int argc, char** argv){
+
+	uint32_t format = STANDARD_PACK_FORMAT;
+	int first = 1;
+
+	if (argc > 2 && std::string(argv[1]) == "-f"){
+		format = SDL_PIXELFORMAT_UNKNOWN;
+		for (const FormatName& f : FORMAT_NAMES){
+			if (std::string(argv[2]) == f.name) format = f.format;
+		}
+		if (format == SDL_PIXELFORMAT_UNKNOWN){
+			std::cout << "Unknown pixel format: " << argv[2] << std::endl;
+			return 1;
+		}
+		first = 3;
+	}
+
+	if (argc - first < 2){
+		std::cout << "Usage: asset_packer [-f FORMAT] out.pack image1.png image2.png ..." << std::endl;
+		return 1;
+	}
+
+	SDL_Init(0);
+	IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+
+	std::vector<std::string> paths;
+	for (int i = first + 1; i < argc; i++) paths.push_back(argv[i]);
+
+	bool ok = AssetPack::write(argv[first], paths, format);
+	if (ok) std::cout << "Packed " << paths.size() << " images into " << argv[first] << std::endl;
+
+	IMG_Quit();
+	SDL_Quit();
+
+	return ok ? 0 : 1;
+}
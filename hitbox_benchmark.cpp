@@ -0,0 +1,222 @@
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include "SDL_Libs/gameobject.h"
+
+/*
+*
+*	Cost of one hitbox test, the old virtual hits with dynamic_cast against the type table of hitbox.h,
+*	once on Hitbox* made with new and once on HitboxShape values stored next to each other.
+*	Then the same for whole objects, GameObject2D::hits with value hitboxes against heap hitboxes.
+*	Every hitbox is tested against every other one, half are rectangles and half circles in a small area.
+*	Usage: hitbox_benchmark [HITBOXES] [ROUNDS]
+*
+*/
+
+const int BENCH_AREA = 1000;
+const int MAX_HITBOX_SIZE = 40;
+const int OBJECT_SHARE = 4;//the object test uses this part of the hitboxes, it does more work per pair
+
+class BenchObject: public GameObject2D{
+public:
+	BenchObject(): GameObject2D(0, 0, 0, 0, nullptr){}
+};
+
+//the hitboxes as they were before the type table, kept here to measure against
+namespace virtual_hitbox{
+
+	class Hitbox{
+	public:
+		HitboxType type = HitboxType::NO_HITBOX;
+		virtual bool hits(Hitbox* other)=0;
+		virtual ~Hitbox(){}
+	};
+
+	class RectangularHitbox : public Hitbox{
+	public:
+		int x=0, y=0, w=0, h=0;
+		RectangularHitbox(int x_, int y_, int w_, int h_): x(x_), y(y_), w(w_), h(h_){ type = HitboxType::RECTANGULAR; }
+		bool hits(Hitbox* other);
+	};
+
+	class CircularHitbox : public Hitbox{
+	public:
+		int x=0, y=0, r=0;
+		CircularHitbox(int x_, int y_, int r_): x(x_), y(y_), r(r_){ type = HitboxType::CIRCULAR; }
+		bool hits(Hitbox* other);
+	};
+
+	static bool circle_hits_rect(CircularHitbox* ch, RectangularHitbox* rh){
+
+		int cx, cy;
+		if (ch->x < rh->x) cx = rh->x;
+		else if (ch->x > rh->x+rh->w) cx = rh->x+rh->w;
+		else cx = ch->x;
+		if (ch->y < rh->y) cy = rh->y;
+		else if (ch->y > rh->y+rh->h) cy = rh->y+rh->h;
+		else cy = ch->y;
+
+		int cdx = ch->x-cx, cdy = ch->y-cy;
+		return (cdx*cdx + cdy*cdy) < ch->r*ch->r;
+
+	}
+
+	bool CircularHitbox::hits(Hitbox* o){
+
+		switch(o->type){
+			case HitboxType::CIRCULAR:{
+				CircularHitbox* ch = dynamic_cast<CircularHitbox*>(o);
+				int xdist = (x-ch->x)*(x-ch->x), ydist = (y-ch->y)*(y-ch->y);
+				return sqrt(xdist+ydist) < (r+ch->r);
+			}
+			case HitboxType::RECTANGULAR: return circle_hits_rect(this, dynamic_cast<RectangularHitbox*>(o));
+			default: return false;
+		}
+
+	}
+
+	bool RectangularHitbox::hits(Hitbox* o){
+
+		switch(o->type){
+			case HitboxType::RECTANGULAR:{
+				RectangularHitbox* other = dynamic_cast<RectangularHitbox*>(o);
+				return !(x+w <= other->x || x >= other->x+other->w || y >= other->y+other->h || y+h <= other->y);
+			}
+			case HitboxType::CIRCULAR: return circle_hits_rect(dynamic_cast<CircularHitbox*>(o), this);
+			default: return false;
+		}
+
+	}
+
+}
+
+static double now_ms(){
+	return SDL_GetPerformanceCounter() * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+//hits counts the colliding pairs, the result is per test in nanoseconds
+template <typename T>
+static double run(std::vector<T*>& hitboxes, int rounds, long long& hits){
+
+	hits = 0;
+	double start = now_ms();
+	for (int r = 0; r < rounds; r++){
+		for (T* a : hitboxes){
+			for (T* b : hitboxes) hits += a->hits(b) ? 1 : 0;
+		}
+	}
+	double tests = static_cast<double>(hitboxes.size()) * hitboxes.size() * rounds;
+	return (now_ms() - start) * 1e6 / tests;
+
+}
+
+static double run(const std::vector<HitboxShape>& shapes, int rounds, long long& hits){
+
+	hits = 0;
+	double start = now_ms();
+	for (int r = 0; r < rounds; r++){
+		for (const HitboxShape& a : shapes){
+			for (const HitboxShape& b : shapes) hits += a.hits(b) ? 1 : 0;
+		}
+	}
+	double tests = static_cast<double>(shapes.size()) * shapes.size() * rounds;
+	return (now_ms() - start) * 1e6 / tests;
+
+}
+
+static double run(std::vector<BenchObject>& objects, int rounds, long long& hits){
+
+	hits = 0;
+	double start = now_ms();
+	for (int r = 0; r < rounds; r++){
+		for (BenchObject& a : objects){
+			for (BenchObject& b : objects) hits += a.hits(&b) ? 1 : 0;
+		}
+	}
+	double tests = static_cast<double>(objects.size()) * objects.size() * rounds;
+	return (now_ms() - start) * 1e6 / tests;
+
+}
+
+int main(int argc, char** argv){
+
+	int count = (argc > 1) ? std::atoi(argv[1]) : 2000;
+	int rounds = (argc > 2) ? std::atoi(argv[2]) : 5;
+	if (count < 1) count = 1;
+	if (rounds < 1) rounds = 1;
+
+	std::mt19937 rng(1);
+	std::vector<virtual_hitbox::Hitbox*> before;
+	std::vector<Hitbox*> after;
+	std::vector<HitboxShape> shapes;
+	int object_count = count / OBJECT_SHARE + 1;
+	std::vector<BenchObject> value_objects(object_count), heap_objects(object_count);
+	for (int i = 0; i < count; i++){
+		int x = rng() % BENCH_AREA, y = rng() % BENCH_AREA;
+		if (rng() % 2){
+			int w = rng() % MAX_HITBOX_SIZE, h = rng() % MAX_HITBOX_SIZE;
+			before.push_back(new virtual_hitbox::RectangularHitbox(x, y, w, h));
+			after.push_back(new RectangularHitbox(x, y, w, h));
+			shapes.push_back(HitboxShape::rectangle(x, y, w, h));
+		}
+		else{
+			int r = rng() % (MAX_HITBOX_SIZE / 2);
+			before.push_back(new virtual_hitbox::CircularHitbox(x, y, r));
+			after.push_back(new CircularHitbox(x, y, r));
+			shapes.push_back(HitboxShape::circular(x, y, r));
+		}
+		//two hitboxes per object, so the object test walks a list
+		if (i < 2 * object_count){
+			value_objects[i / 2].add_hitbox(shapes.back());
+			if (after.back()->type == HitboxType::RECTANGULAR){
+				RectangularHitbox* rh = static_cast<RectangularHitbox*>(after.back());
+				heap_objects[i / 2].add_hitbox(rh->x, rh->y, rh->w, rh->h);
+			}
+			else{
+				CircularHitbox* ch = static_cast<CircularHitbox*>(after.back());
+				heap_objects[i / 2].add_hitbox(ch->x, ch->y, ch->r, 0, HitboxType::CIRCULAR);
+			}
+		}
+	}
+
+	std::cout << count << " hitboxes, " << static_cast<long long>(count) * count * rounds << " tests" << std::endl;
+
+	long long before_hits = 0, after_hits = 0, value_hits = 0;
+	double before_ns = run(before, rounds, before_hits);
+	double after_ns = run(after, rounds, after_hits);
+	double value_ns = run(shapes, rounds, value_hits);
+
+	std::cout << "virtual hits with dynamic_cast: " << before_ns << " ns per test" << std::endl;
+	std::cout << "type table on Hitbox*: " << after_ns << " ns per test" << std::endl;
+	std::cout << "type table on HitboxShape values: " << value_ns << " ns per test" << std::endl;
+
+	long long heap_object_hits = 0, value_object_hits = 0;
+	double heap_object_ns = run(heap_objects, rounds, heap_object_hits);
+	double value_object_ns = run(value_objects, rounds, value_object_hits);
+
+	std::cout << object_count << " objects with two hitboxes each" << std::endl;
+	std::cout << "GameObject2D::hits on heap hitboxes: " << heap_object_ns << " ns per test" << std::endl;
+	std::cout << "GameObject2D::hits on value hitboxes: " << value_object_ns << " ns per test" << std::endl;
+
+	for (virtual_hitbox::Hitbox* h : before) delete h;
+	for (Hitbox* h : after) delete h;
+
+	if (before_hits != after_hits || before_hits != value_hits || heap_object_hits != value_object_hits){
+		std::cout << "the tests disagree: " << before_hits << " hits before, " << after_hits << " on Hitbox*, " << value_hits << " on values, "
+			<< heap_object_hits << " and " << value_object_hits << " on objects" << std::endl;
+		return 1;
+	}
+	return 0;
+}
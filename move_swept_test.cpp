@@ -0,0 +1,123 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include "SDL_Libs/gameobject.h"
+
+/*
+*
+*	Checks GameObject2D::move_swept with random fast moves between thin walls, boxes and circles.
+*	A move may never end inside an object the mover did not hit before, stopped or not,
+*	and the hitboxes have to stay at the same distance to X() and Y() however many fractional moves are made.
+*	Usage: move_swept_test [MOVES] [SEED]
+*	Gives back 0 if every move passed.
+*
+*/
+
+const int WORLD_SIZE = 600;
+const int OBSTACLES = 40;
+const double MAX_MOVE = 120.0;//far more than the thinnest wall, so plain moves would tunnel
+
+class TestObject: public GameObject2D{
+public:
+	TestObject(double x, double y): GameObject2D(x, y, 0, 0, nullptr){}
+};
+
+//position of the first hitbox, to see whether it still follows X() and Y()
+static void hitbox_origin(GameObject2D& o, int& hx, int& hy){
+
+	Hitbox* h = (*o.get_hitboxes())[0];
+	if (h->type == HitboxType::RECTANGULAR){
+		hx = static_cast<RectangularHitbox*>(h)->x;
+		hy = static_cast<RectangularHitbox*>(h)->y;
+	}
+	else{
+		hx = static_cast<CircularHitbox*>(h)->x;
+		hy = static_cast<CircularHitbox*>(h)->y;
+	}
+
+}
+
+int main(int argc, char** argv){
+
+	int moves = (argc > 1) ? std::atoi(argv[1]) : 100000;
+	unsigned int seed = (argc > 2) ? static_cast<unsigned int>(std::atoi(argv[2])) : 1;
+
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> move(-MAX_MOVE, MAX_MOVE);
+
+	std::vector<TestObject*> obstacles;
+	std::vector<GameObject2D*> others;
+	for (int i = 0; i < OBSTACLES; i++){
+
+		int x = rng() % WORLD_SIZE, y = rng() % WORLD_SIZE;
+		TestObject* o = new TestObject(x, y);
+		switch (rng() % 4){
+			case 0: o->add_hitbox(x, y, 1 + rng() % 3, 40 + rng() % 200); break;//thin wall
+			case 1: o->add_hitbox(x, y, 40 + rng() % 200, 1 + rng() % 3); break;
+			case 2: o->add_hitbox(x, y, 5 + rng() % 40, 5 + rng() % 40); break;
+			default: o->add_hitbox(x, y, 3 + rng() % 25, 0, HitboxType::CIRCULAR); break;
+		}
+		obstacles.push_back(o);
+		others.push_back(o);
+
+	}
+
+	int failures = 0, stopped_moves = 0, drifted = 0;
+	for (int shape = 0; shape < 2; shape++){
+
+		TestObject mover(WORLD_SIZE / 2, WORLD_SIZE / 2);
+		if (shape == 0) mover.add_hitbox(WORLD_SIZE / 2, WORLD_SIZE / 2, 6, 6);
+		else mover.add_hitbox(WORLD_SIZE / 2, WORLD_SIZE / 2, 4, 0, HitboxType::CIRCULAR);
+
+		int ox, oy;
+		hitbox_origin(mover, ox, oy);
+		ox -= mover.X();
+		oy -= mover.Y();
+
+		for (int m = 0; m < moves; m++){
+
+			std::vector<GameObject2D*> before;
+			for (GameObject2D* o : others){
+				if (mover.hits(o)) before.push_back(o);
+			}
+
+			double dx = move(rng), dy = move(rng);
+			//some moves along one axis only, they hit walls straight on
+			if (m % 5 == 0) dx = 0;
+			if (m % 7 == 0) dy = 0;
+
+			SweepHit hit;
+			if (mover.move_swept(dx, dy, others, &hit)) stopped_moves++;
+
+			for (GameObject2D* o : others){
+				if (std::find(before.begin(), before.end(), o) != before.end() || !mover.hits(o)) continue;
+				failures++;
+				if (failures <= 5) std::cout << "move " << m << " by " << dx << ", " << dy << " ended inside an obstacle, time " << hit.time << std::endl;
+			}
+
+			int hx, hy;
+			hitbox_origin(mover, hx, hy);
+			if (hx - mover.X() != ox || hy - mover.Y() != oy) drifted++;
+
+			//back into the world or away from what it is stuck at, without checking collisions
+			if (mover.X() < 0 || mover.X() > WORLD_SIZE || mover.Y() < 0 || mover.Y() > WORLD_SIZE || hit.time == 0){
+				mover.changeX(rng() % WORLD_SIZE);
+				mover.changeY(rng() % WORLD_SIZE);
+				hitbox_origin(mover, ox, oy);
+				ox -= mover.X();
+				oy -= mover.Y();
+			}
+
+		}
+
+	}
+
+	for (TestObject* o : obstacles) delete o;
+
+	std::cout << 2 * moves << " moves, " << stopped_moves << " stopped, " << failures << " ended inside an obstacle, "
+		<< drifted << " with hitboxes away from X() and Y()" << std::endl;
+
+	return (failures == 0 && drifted == 0) ? 0 : 1;
+}
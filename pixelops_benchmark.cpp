@@ -0,0 +1,114 @@
+#ifdef _WIN32
+#include <SDL.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include "SDL_Libs/pixelops.h"
+
+/*
+*
+*	Megapixels per second of every pixelops kernel, for each level the CPU supports.
+*	Also checks that all levels give the same pixels.
+*	Usage: pixelops_benchmark [WIDTH HEIGHT] [ROUNDS]
+*
+*/
+
+const int BENCH_WIDTH = 1920;
+const int BENCH_HEIGHT = 1080;
+const int BENCH_ROUNDS = 20;
+
+const char* LEVEL_NAMES[] = {"scalar", "SSE2", "AVX2"};
+
+struct Kernel{
+	const char* name;
+	std::function<void(SDL_Surface*)> run;
+};
+
+static double now_ms(){
+	return SDL_GetPerformanceCounter() * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static void copy_pixels(SDL_Surface* to, const SDL_Surface* from){
+	memcpy(to->pixels, from->pixels, static_cast<size_t>(from->pitch) * from->h);
+}
+
+int main(int argc, char** argv){
+
+	int w = (argc > 2) ? std::atoi(argv[1]) : BENCH_WIDTH;
+	int h = (argc > 2) ? std::atoi(argv[2]) : BENCH_HEIGHT;
+	int rounds = (argc > 3) ? std::atoi(argv[3]) : (argc == 2 ? std::atoi(argv[1]) : BENCH_ROUNDS);
+
+	SDL_Init(0);
+
+	SDL_Surface* source = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_Surface* work = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_Surface* reference = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (source == nullptr || work == nullptr || reference == nullptr){
+		std::cout << "Surfaces could not be created: " << SDL_GetError() << std::endl;
+		return 1;
+	}
+
+	//random colors with some pixels of the keyed color
+	std::mt19937 rng(1);
+	uint32_t* pixels = static_cast<uint32_t*>(source->pixels);
+	uint32_t key = SDL_MapRGBA(source->format, 0xff, 0x00, 0xff, 0xff);
+	for (int y = 0; y < h; y++){
+		for (int x = 0; x < w; x++) pixels[y * (source->pitch / 4) + x] = (rng() % 8 == 0) ? key : rng();
+	}
+
+	std::vector<Kernel> kernels = {
+		{"tint", [](SDL_Surface* s){ tint_pixels(s, 0xff, 0x80, 0x40); }},
+		{"premultiply", [](SDL_Surface* s){ premultiply_alpha(s); }},
+		{"color key", [](SDL_Surface* s){ color_key_pixels(s, 0xff, 0x00, 0xff); }},
+		{"box blur r=2", [](SDL_Surface* s){ box_blur_pixels(s, 2); }},
+		{"box blur r=8", [](SDL_Surface* s){ box_blur_pixels(s, 8); }}
+	};
+
+	PixelOpsLevel best = pixelops_level();
+	double megapixels = static_cast<double>(w) * h / 1e6;
+	std::cout << w << "x" << h << ", " << rounds << " rounds, best level " << LEVEL_NAMES[best] << std::endl;
+
+	for (const Kernel& k : kernels){
+
+		for (int level = PIXELOPS_SCALAR; level <= best; level++){
+
+			pixelops_force_level(static_cast<PixelOpsLevel>(level));
+
+			//the copy back to the untouched pixels is not timed
+			double total = 0;
+			for (int r = 0; r < rounds; r++){
+				copy_pixels(work, source);
+				double start = now_ms();
+				k.run(work);
+				total += now_ms() - start;
+			}
+
+			bool same = true;
+			if (level == PIXELOPS_SCALAR) copy_pixels(reference, work);
+			else same = memcmp(reference->pixels, work->pixels, static_cast<size_t>(work->pitch) * work->h) == 0;
+
+			std::cout << k.name << ", " << LEVEL_NAMES[level] << ": " << megapixels * rounds / (total / 1000.0) << " MP/s";
+			if (!same) std::cout << " DIFFERENT FROM SCALAR";
+			std::cout << std::endl;
+
+		}
+
+	}
+
+	pixelops_force_level(best);
+	SDL_FreeSurface(source);
+	SDL_FreeSurface(work);
+	SDL_FreeSurface(reference);
+	SDL_Quit();
+
+	return 0;
+}
@@ -0,0 +1,123 @@
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_ttf.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+#include "SDL_Libs/sdffont.h"
+
+/*
+*
+*	Compares the memory and the frame time of SdfFont against one bitmap GlyphAtlas per size, on the software renderer.
+*	A label is zoomed through every size from MIN_SIZE to MAX_SIZE, like text on a zooming camera.
+*	The first pass rasterizes, the later passes only draw out of the pages.
+*	Usage: sdffont_benchmark FONT.ttf [PASSES]
+*	SDL_VIDEODRIVER=dummy runs it without a display.
+*
+*/
+
+const int MIN_SIZE = 8;
+const int MAX_SIZE = 96;
+const int LINES = 8;//lines of the label drawn per frame
+const int BENCH_WIDTH = 1280;
+const int BENCH_HEIGHT = 720;
+const std::string LABEL = "The quick brown fox jumps over the lazy dog 0123456789";
+
+static double now_ms(){
+	return SDL_GetPerformanceCounter() * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static size_t atlas_bytes(const std::map<int, GlyphAtlas*>& atlases){
+	size_t bytes = 0;
+	for (auto& a : atlases) bytes += a.second->page_count() * static_cast<size_t>(STANDARD_GLYPH_PAGE_SIZE) * STANDARD_GLYPH_PAGE_SIZE * sizeof(uint32_t);
+	return bytes;
+}
+
+int main(int argc, char** argv){
+
+	if (argc < 2){
+		std::cout << "Usage: sdffont_benchmark FONT.ttf [PASSES]" << std::endl;
+		return 1;
+	}
+	std::string font_path = argv[1];
+	int passes = (argc > 2) ? std::atoi(argv[2]) : 10;
+	if (passes < 2) passes = 2;
+
+	SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+	SDL_Init(SDL_INIT_VIDEO);
+	TTF_Init();
+
+	{
+
+		Window window("sdffont_benchmark", 0, 0, BENCH_WIDTH, BENCH_HEIGHT, SDL_WINDOW_HIDDEN);
+		if (window.renderer == nullptr){
+			std::cout << "No renderer: " << SDL_GetError() << std::endl;
+			return 1;
+		}
+
+		int frames = MAX_SIZE - MIN_SIZE + 1;
+		std::cout << "\"" << LABEL << "\" x " << LINES << " lines, sizes " << MIN_SIZE << " to " << MAX_SIZE << ", " << passes << " passes" << std::endl;
+
+		//bitmap path, what Font in glyph mode does: one atlas per point size
+		std::map<int, GlyphAtlas*> atlases;
+		double atlas_first = 0.0, atlas_rest = 0.0;
+		for (int pass = 0; pass < passes; pass++){
+			double start = now_ms();
+			for (int size = MIN_SIZE; size <= MAX_SIZE; size++){
+				GlyphAtlas*& atlas = atlases[size];
+				if (atlas == nullptr) atlas = GlyphAtlas::acquire(font_path, size, &window);
+				SDL_RenderClear(window.renderer);
+				for (int l = 0; l < LINES; l++) atlas->draw(LABEL, 0, l * size, GLYPH_WHITE);
+				SDL_RenderPresent(window.renderer);
+			}
+			double ms = now_ms() - start;
+			if (pass == 0) atlas_first = ms;
+			else atlas_rest += ms;
+		}
+
+		unsigned int atlas_pages = 0;
+		for (auto& a : atlases) atlas_pages += a.second->page_count();
+		std::cout << "GlyphAtlas per size: " << atlases.size() << " atlases, " << atlas_pages << " pages, "
+			<< atlas_bytes(atlases) / 1024 << " KiB, first pass " << atlas_first / frames << " ms per frame, later passes "
+			<< atlas_rest / (passes - 1) / frames << " ms per frame" << std::endl;
+
+		for (auto& a : atlases) GlyphAtlas::release(a.second);
+		atlases.clear();
+
+		//distance field path, one font for every size
+		SdfFont* sdf = SdfFont::acquire(font_path, &window);
+		double sdf_first = 0.0, sdf_rest = 0.0;
+		for (int pass = 0; pass < passes; pass++){
+			double start = now_ms();
+			for (int size = MIN_SIZE; size <= MAX_SIZE; size++){
+				SDL_RenderClear(window.renderer);
+				for (int l = 0; l < LINES; l++) sdf->draw(LABEL, 0, l * size, static_cast<float>(size), GLYPH_WHITE);
+				SDL_RenderPresent(window.renderer);
+			}
+			double ms = now_ms() - start;
+			if (pass == 0) sdf_first = ms;
+			else sdf_rest += ms;
+		}
+
+		std::cout << "SdfFont: " << sdf->bucket_count() << " scales, " << sdf->memory_bytes() / 1024 << " KiB, first pass "
+			<< sdf_first / frames << " ms per frame, later passes " << sdf_rest / (passes - 1) / frames << " ms per frame" << std::endl;
+
+		SdfFont::release(sdf);
+
+	}
+
+	TTF_Quit();
+	SDL_Quit();
+
+	return 0;
+}
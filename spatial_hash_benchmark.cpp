@@ -0,0 +1,136 @@
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include "SDL_Libs/spatial_hash.h"
+#include "SDL_Libs/collision_tree.h"
+
+/*
+*
+*	Compares finding all colliding pairs with brute force GameObject2D::hits against the SpatialHash and the CollisionTree.
+*	Every frame each object moves a little and all pairs are searched again, the density stays the same for every count.
+*	Brute force gets one frame only, it grows with the square of the objects.
+*	Usage: spatial_hash_benchmark [FRAMES]
+*
+*/
+
+const int COUNTS[] = {1000, 10000, 50000};
+const int AREA_PER_OBJECT = 128;//the world side is this times the square root of the object count
+const int MAX_OBJECT_SIZE = 32;
+const int MAX_STEP = 4;//pixels an object moves per frame
+
+class BenchObject: public GameObject2D{
+public:
+	BenchObject(): GameObject2D(0, 0, 0, 0, nullptr){}
+};
+
+enum class Broadphase{BRUTE_FORCE, SPATIAL_HASH, COLLISION_TREE};
+
+static double now_ms(){
+	return SDL_GetPerformanceCounter() * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+//the same seed gives every broad phase the same objects and moves
+static void make_objects(std::vector<BenchObject>& objects, int count, std::mt19937& rng){
+
+	int side = static_cast<int>(AREA_PER_OBJECT * std::sqrt(static_cast<double>(count)));
+	objects.resize(count);
+	for (BenchObject& o : objects){
+		int x = rng() % side, y = rng() % side;
+		if (rng() % 2) o.add_hitbox(x, y, 4 + rng() % (MAX_OBJECT_SIZE - 4), 4 + rng() % (MAX_OBJECT_SIZE - 4));
+		else o.add_hitbox(x, y, 2 + rng() % (MAX_OBJECT_SIZE / 2 - 2), 0, HitboxType::CIRCULAR);
+	}
+
+}
+
+static void move_objects(std::vector<BenchObject>& objects, std::mt19937& rng){
+	for (BenchObject& o : objects){
+		o.moveRight(static_cast<int>(rng() % (2 * MAX_STEP + 1)) - MAX_STEP);
+		o.moveDown(static_cast<int>(rng() % (2 * MAX_STEP + 1)) - MAX_STEP);
+	}
+}
+
+//gives back ms per frame, pairs holds the colliding pairs of the first frame
+static double run(Broadphase mode, int count, int frames, size_t& pairs){
+
+	std::mt19937 rng(1);
+	std::vector<BenchObject> objects;
+	make_objects(objects, count, rng);
+
+	SpatialHash hash(MAX_OBJECT_SIZE * 2);
+	CollisionTree tree;
+	CollisionWorld* world = nullptr;
+	if (mode == Broadphase::SPATIAL_HASH) world = &hash;
+	if (mode == Broadphase::COLLISION_TREE) world = &tree;
+	if (world != nullptr){
+		for (BenchObject& o : objects) world->insert(&o);
+	}
+
+	std::vector<CollisionPair> found;
+	double start = now_ms();
+	for (int f = 0; f < frames; f++){
+
+		move_objects(objects, rng);
+
+		found.clear();
+		if (mode == Broadphase::BRUTE_FORCE){
+			for (size_t i = 0; i < objects.size(); i++){
+				for (size_t j = i + 1; j < objects.size(); j++){
+					if (objects[i].hits(&objects[j])) found.push_back(CollisionPair(&objects[i], &objects[j]));
+				}
+			}
+		}
+		else if (mode == Broadphase::SPATIAL_HASH) hash.pairs(found);
+		else tree.pairs(found);
+
+		if (f == 0) pairs = found.size();
+
+	}
+	double ms = (now_ms() - start) / frames;
+
+	//the objects leave their world before it goes
+	if (world != nullptr){
+		for (BenchObject& o : objects) world->remove(&o);
+	}
+	return ms;
+
+}
+
+int main(int argc, char** argv){
+
+	int frames = (argc > 1) ? std::atoi(argv[1]) : 20;
+	if (frames < 1) frames = 1;
+
+	int mismatches = 0;
+	for (int count : COUNTS){
+
+		size_t brute_pairs = 0, hash_pairs = 0, tree_pairs = 0;
+		double brute = run(Broadphase::BRUTE_FORCE, count, 1, brute_pairs);
+		double hash = run(Broadphase::SPATIAL_HASH, count, frames, hash_pairs);
+		double tree = run(Broadphase::COLLISION_TREE, count, frames, tree_pairs);
+
+		std::cout << count << " objects, " << brute_pairs << " colliding pairs" << std::endl;
+		std::cout << "	brute force hits: " << brute << " ms per frame" << std::endl;
+		std::cout << "	SpatialHash: " << hash << " ms per frame, " << brute / hash << " times faster" << std::endl;
+		std::cout << "	CollisionTree: " << tree << " ms per frame, " << brute / tree << " times faster" << std::endl;
+
+		if (hash_pairs != brute_pairs || tree_pairs != brute_pairs){
+			std::cout << "	pairs differ: " << hash_pairs << " in the SpatialHash, " << tree_pairs << " in the CollisionTree" << std::endl;
+			mismatches++;
+		}
+
+	}
+
+	return (mismatches == 0) ? 0 : 1;
+}
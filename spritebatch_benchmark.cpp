@@ -0,0 +1,142 @@
+#ifdef _WIN32
+#include <SDL.h>
+#include <SDL_image.h>
+#undef main
+#else
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#endif
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include "SDL_Libs/spritebatch.h"
+
+/*
+*
+*	Compares drawing sprites one by one with Texture::draw against a SpriteBatch, on the software renderer.
+*	Usage: spritebatch_benchmark [SPRITES] [FRAMES]
+*	SDL_VIDEODRIVER=dummy runs it without a display.
+*
+*/
+
+const int SPRITE_SIZE = 32;
+const int IMAGE_COUNT = 4;
+const int BENCH_WIDTH = 1280;
+const int BENCH_HEIGHT = 720;
+
+static double now_ms(){
+	return SDL_GetPerformanceCounter() * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+//a plain colored square, written next to the program so the benchmark needs no assets
+static std::string make_image(int i){
+
+	SDL_Surface* s = SDL_CreateRGBSurfaceWithFormat(0, SPRITE_SIZE, SPRITE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_FillRect(s, nullptr, SDL_MapRGBA(s->format, 60 * i, 255 - 60 * i, 128, 200));
+	std::string path = "spritebatch_benchmark_" + std::to_string(i) + ".bmp";
+	SDL_SaveBMP(s, path.c_str());
+	SDL_FreeSurface(s);
+	return path;
+
+}
+
+//frame draws one frame and gives back its draw calls
+static void run(const char* name, Window& window, int frames, const std::function<unsigned int()>& frame){
+
+	unsigned int calls = 0;
+	double start = now_ms();
+	for (int f = 0; f < frames; f++){
+		SDL_RenderClear(window.renderer);
+		calls = frame();
+		SDL_RenderPresent(window.renderer);
+	}
+	double ms = (now_ms() - start) / frames;
+
+	std::cout << name << ": " << ms << " ms per frame, " << calls << " draw calls" << std::endl;
+
+}
+
+int main(int argc, char** argv){
+
+	int sprites = (argc > 1) ? std::atoi(argv[1]) : 10000;
+	int frames = (argc > 2) ? std::atoi(argv[2]) : 100;
+
+	SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+	SDL_Init(SDL_INIT_VIDEO);
+	IMG_Init(IMG_INIT_PNG);
+
+	{
+
+		Window window("spritebatch_benchmark", 0, 0, BENCH_WIDTH, BENCH_HEIGHT, SDL_WINDOW_HIDDEN);
+		if (window.renderer == nullptr){
+			std::cout << "No renderer: " << SDL_GetError() << std::endl;
+			return 1;
+		}
+
+		std::vector<std::string> paths;
+		std::vector<Texture> textures;
+		TextureAtlas atlas(&window);
+		for (int i = 0; i < IMAGE_COUNT; i++){
+			paths.push_back(make_image(i));
+			textures.push_back(Texture(paths.back(), &window));
+			atlas.add(paths.back());
+		}
+		atlas.build();
+
+		std::vector<AtlasSprite> atlas_sprites;
+		for (const std::string& p : paths) atlas_sprites.push_back(atlas.get(p));
+
+		std::mt19937 rng(1);
+		std::vector<SDL_Point> positions;
+		for (int i = 0; i < sprites; i++){
+			positions.push_back(SDL_Point{static_cast<int>(rng() % (BENCH_WIDTH - SPRITE_SIZE)), static_cast<int>(rng() % (BENCH_HEIGHT - SPRITE_SIZE))});
+		}
+
+		SpriteBatch batch(&window, sprites);
+		std::cout << sprites << " sprites of " << SPRITE_SIZE << "x" << SPRITE_SIZE << ", " << frames << " frames" << std::endl;
+
+		run("Texture::draw, one image", window, frames, [&](){
+			for (const SDL_Point& p : positions) textures[0].draw(p.x, p.y);
+			return static_cast<unsigned int>(positions.size());
+		});
+
+		run("SpriteBatch, one image", window, frames, [&](){
+			batch.begin();
+			for (const SDL_Point& p : positions) batch.add(textures[0], p.x, p.y);
+			batch.end();
+			return batch.get_draw_calls();
+		});
+
+		run("Texture::draw, images alternating", window, frames, [&](){
+			for (size_t i = 0; i < positions.size(); i++) textures[i % IMAGE_COUNT].draw(positions[i].x, positions[i].y);
+			return static_cast<unsigned int>(positions.size());
+		});
+
+		run("SpriteBatch, images alternating", window, frames, [&](){
+			batch.begin();
+			for (size_t i = 0; i < positions.size(); i++) batch.add(textures[i % IMAGE_COUNT], positions[i].x, positions[i].y);
+			batch.end();
+			return batch.get_draw_calls();
+		});
+
+		run("SpriteBatch, images alternating on one atlas page", window, frames, [&](){
+			batch.begin();
+			for (size_t i = 0; i < positions.size(); i++) batch.add(atlas_sprites[i % IMAGE_COUNT], positions[i].x, positions[i].y);
+			batch.end();
+			return batch.get_draw_calls();
+		});
+
+		for (const std::string& p : paths) std::remove(p.c_str());
+
+	}
+
+	IMG_Quit();
+	SDL_Quit();
+
+	return 0;
+}